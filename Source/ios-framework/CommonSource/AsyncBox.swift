@@ -66,14 +66,17 @@ where E == E.EntityBindingType.EntityType {
         return cAsyncBox
     }
     
+    /// - Parameter newIds: IDs reserved for new objects of a bulk put (see `ReservedIds`); nil to get a new ID from the
+    ///   box's ID sequence.
     internal func putOne(_ entity: EntityType, binding: EntityType.EntityBindingType,
-                         flatBuffer: FlatBufferBuilder, mode: PutMode) throws -> Id {
+                         flatBuffer: FlatBufferBuilder, mode: PutMode, newIds: inout ReservedIds?) throws -> Id {
         let cAsyncBox = try cHandle()
         flatBuffer.isCollecting = true
         defer { flatBuffer.clear(); flatBuffer.isCollecting = false }
         
         let entityId = binding.entityId(of: entity)
-        let actualId = obx_box_id_for_put(box.cBox, entityId)
+        let actualId = entityId == 0 && newIds != nil ? try newIds!.next()
+            : try checkIdForPut(obx_box_id_for_put(box.cBox, entityId))
         try binding.collect(fromEntity: entity, id: actualId, propertyCollector: flatBuffer, store: box.store)
         flatBuffer.ensureStarted()
         let data = try flatBuffer.finish()
@@ -91,7 +94,8 @@ where E == E.EntityBindingType.EntityType {
         let flatBuffer = FlatBufferBuilder.dequeue()
         defer { FlatBufferBuilder.return(flatBuffer) }
         
-        let entityId = try putOne(entity, binding: binding, flatBuffer: flatBuffer, mode: mode)
+        var newIds: ReservedIds?
+        let entityId = try putOne(entity, binding: binding, flatBuffer: flatBuffer, mode: mode, newIds: &newIds)
         binding.setEntityIdUnlessStruct(of: entity, to: entityId)
         return EntityId(entityId)
     }
@@ -110,8 +114,10 @@ where E == E.EntityBindingType.EntityType {
             return try [EntityId<EntityType>](unsafeUninitializedCapacity: entities.count)
             { ptr, initializedCount in
                 initializedCount = 0
+                var newIds: ReservedIds? = ReservedIds(cBox: box.cBox, for: entities, binding: binding)
                 for entity in entities {
-                    let entityId = try putOne(entity, binding: binding, flatBuffer: flatBuffer, mode: mode)
+                    let entityId = try putOne(entity, binding: binding, flatBuffer: flatBuffer, mode: mode,
+                                              newIds: &newIds)
                     binding.setEntityIdUnlessStruct(of: entity, to: entityId)
                     ptr[initializedCount] = EntityId(entityId)
                     initializedCount += 1
@@ -130,8 +136,10 @@ where E == E.EntityBindingType.EntityType {
             return try [EntityId<EntityType>](unsafeUninitializedCapacity: entities.count)
             { ptr, initializedCount in
                 initializedCount = 0
+                var newIds: ReservedIds? = ReservedIds(cBox: box.cBox, for: entities, binding: binding)
                 for entity in entities {
-                    let entityId = try putOne(entity, binding: binding, flatBuffer: flatBuffer, mode: mode)
+                    let entityId = try putOne(entity, binding: binding, flatBuffer: flatBuffer, mode: mode,
+                                              newIds: &newIds)
                     binding.setEntityIdUnlessStruct(of: entity, to: entityId)
                     ptr[initializedCount] = EntityId(entityId)
                     initializedCount += 1
@@ -151,8 +159,10 @@ where E == E.EntityBindingType.EntityType {
             return try ContiguousArray<EntityId<EntityType>>(unsafeUninitializedCapacity: entities.count)
             { ptr, initializedCount in
                 initializedCount = 0
+                var newIds: ReservedIds? = ReservedIds(cBox: box.cBox, for: entities, binding: binding)
                 for entity in entities {
-                    let entityId = try putOne(entity, binding: binding, flatBuffer: flatBuffer, mode: mode)
+                    let entityId = try putOne(entity, binding: binding, flatBuffer: flatBuffer, mode: mode,
+                                              newIds: &newIds)
                     binding.setEntityIdUnlessStruct(of: entity, to: entityId)
                     ptr[initializedCount] = EntityId(entityId)
                     initializedCount += 1
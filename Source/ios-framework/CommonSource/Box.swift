@@ -28,6 +28,51 @@ where E == E.EntityBindingType.EntityType {
     internal let cBox: OpaquePointer /* OBX_box */
     internal let store: Store
 
+    /// If enabled, putting an existing object first compares it with the stored object and skips writing it if it is
+    /// unchanged; thus there are no observer notifications or sync changes either. Relations are still updated.
+    /// Comes at the cost of reading and comparing the stored object, so only enable it if objects are often put without
+    /// changes (e.g. when applying data received from a server). Does not apply to the `insert` put mode.
+    /// Set it before using the box from several threads.
+    public var skipsUnchangedPuts = false
+
+    /// If enabled, putting a large collection serializes its objects on several threads before the write transaction
+    /// begins, so the write lock is only held to write the serialized objects (and relations). IDs for new objects are
+    /// reserved up front, in the order of the collection. Note that all objects are kept serialized until written, so
+    /// the put temporarily needs additional memory of about the serialized size of the whole collection.
+    /// Collecting must be thread safe, i.e. the objects must not be modified during the put, and custom property
+    /// converters must be thread safe. If an object has a to-one relation to an object that was not put yet, the put
+    /// falls back to serializing on the calling thread (using the same IDs).
+    /// Does not apply if `skipsUnchangedPuts` is enabled. Set it before using the box from several threads.
+    public var encodesPutsInParallel = false
+
+    /// If enabled, reading a large number of objects at once (e.g. `all()` or `Query.find()`) creates the objects on
+    /// several threads while the read transaction stays open on the calling thread. The order of the results is kept.
+    /// Creating objects must then be thread safe, i.e. entity initializers and custom property converters must not
+    /// share mutable state. Set it before using the box from several threads.
+    public var decodesReadsInParallel = false
+
+    private var skippedPuts: UInt64 = 0
+    private let skippedPutsLock = DispatchSemaphore(value: 1)
+
+    /// Number of puts that were skipped because the object was unchanged, see `skipsUnchangedPuts`.
+    public var skippedPutCount: UInt64 {
+        skippedPutsLock.wait()
+        defer { skippedPutsLock.signal() }
+        return skippedPuts
+    }
+
+    internal func didSkipPut() {
+        skippedPutsLock.wait()
+        skippedPuts += 1
+        skippedPutsLock.signal()
+    }
+
+    /// Object sizes learned from putting objects of this type, e.g. to tune for large objects.
+    /// Shared by all boxes for this entity type (by its ID) in this process; nil for entity IDs above 1023.
+    public var putSizeHint: PutSizeHint? {
+        return FlatBufferBuilder.sizeHint(entitySchemaId: EntityType.entityInfo.entitySchemaId)
+    }
+
     internal init(store: Store) {
         self.store = store
         cBox = obx_box(store.cStore, EntityType.entityInfo.entitySchemaId)
@@ -68,17 +113,13 @@ where E == E.EntityBindingType.EntityType {
     /// - Parameter ids: IDs of the objects.
     /// - Returns: true if all objects specified exist.
     public func contains(_ ids: [EntityType.EntityBindingType.IdType]) throws -> Bool {
-        var result = true
-
-        try store.obx_runInTransaction(writable: false, { swiftTx in
-            let cursor = try Cursor<EntityType>(transaction: swiftTx)
-
-            for currId in ids where try !cursor.contains(currId.value) {
-                result = false
-                return
-            }
-        })
+        guard !ids.isEmpty else { return true }
+        guard !ids.contains(where: { $0.value == 0 }) else { return false }  // Never stored
 
+        var result = false
+        try withSortedIdArray(ids.lazy.map { $0.value }) { cIds in
+            try checkLastError(obx_box_contains_many(cBox, cIds, &result))
+        }
         return result
     }
 
@@ -157,15 +198,202 @@ extension Box {
         flatBuffer.isCollecting = true
         defer { flatBuffer.clear(); flatBuffer.isCollecting = false }
 
-        let actualId = cursor.idForPut(entity)
+        flatBuffer.start(entitySchemaId: EntityType.entityInfo.entitySchemaId)
+        let actualId = try cursor.idForPut(entity)
         try binding.collect(fromEntity: entity, id: actualId, propertyCollector: flatBuffer, store: store)
         flatBuffer.ensureStarted()
-        let data = try flatBuffer.finish()
-        try cursor.put(id: actualId, data: data, mode: mode)
+        if skipsUnchangedPuts && mode != .insert && binding.entityId(of: entity) != 0 {
+            let data = try flatBuffer.finish()
+            if flatBuffer.matches(try cursor.get(actualId)) {
+                didSkipPut()
+            } else {
+                try cursor.put(id: actualId, data: data, mode: mode)
+            }
+        } else {
+            let data = try flatBuffer.finish()
+            try cursor.put(id: actualId, data: data, mode: mode)
+        }
 
         return actualId
     }
 
+    /// Number of objects serialized into one builder batch before they are put using a single native call.
+    internal static var putBatchSize: Int { return 1000 }
+
+    /// Serializes the given entities into batches of the builder and puts each batch using a single native call,
+    /// instead of crossing into the native layer for each object's finish and put.
+    /// The ID of each entity is set right after collecting it, so that e.g. to-one relations of later entities to a new
+    /// one refer to it instead of putting it again. Relations are written via `postPut()` once the batch holding the
+    /// entity was put, so relation data is never written before the object it belongs to.
+    /// - Parameter newIds: IDs reserved up front for the new objects, instead of one native call each.
+    internal func putBatched<C: Collection>(_ entities: C, binding: EntityType.EntityBindingType,
+                                            flatBuffer: FlatBufferBuilder, mode: PutMode, cursor: Cursor<EntityType>,
+                                            newIds: inout ReservedIds,
+                                            didPut: (_ index: Int, _ entity: EntityType, _ id: Id) throws -> Void)
+        throws where C.Element == EntityType {
+        defer { flatBuffer.clear(); flatBuffer.isCollecting = false; flatBuffer.clearBatch() }
+        let checksUnchanged = skipsUnchangedPuts && mode != .insert
+
+        let batchSize = Swift.min(entities.count, Box.putBatchSize)
+        var pending: [(index: Int, entity: EntityType, id: Id, isNew: Bool)] = []
+        pending.reserveCapacity(batchSize)
+        var pendingIds = Set<Id>()  // Only tracked to check unchanged objects against the data actually stored
+
+        func flush() throws {
+            try cursor.putBatch(flatBuffer, mode: mode)
+            flatBuffer.clearBatch()
+            pendingIds.removeAll(keepingCapacity: true)
+            for object in pending {
+                // Generated postPut() code detects new objects by their unset ID, so unset it for the call
+                if object.isNew {
+                    binding.setEntityIdUnlessStruct(of: object.entity, to: 0)
+                }
+                try binding.postPut(fromEntity: object.entity, id: object.id, store: store)
+                binding.setEntityIdUnlessStruct(of: object.entity, to: object.id)
+                try didPut(object.index, object.entity, object.id)
+            }
+            pending.removeAll(keepingCapacity: true)
+        }
+
+        for (index, entity) in entities.enumerated() {
+            let isNew = binding.entityId(of: entity) == 0
+            let actualId = isNew ? try newIds.next() : try cursor.idForPut(entity)
+            if checksUnchanged && !pendingIds.insert(actualId).inserted {
+                try flush()  // The same object is put again: compare with the pending copy once it is stored
+                pendingIds.insert(actualId)
+            }
+
+            flatBuffer.isCollecting = true
+            flatBuffer.start(entitySchemaId: EntityType.entityInfo.entitySchemaId)
+            try binding.collect(fromEntity: entity, id: actualId, propertyCollector: flatBuffer, store: store)
+            flatBuffer.ensureStarted()
+            if checksUnchanged && !isNew {
+                // An unchanged object is not put, but still passed on to postPut() and didPut
+                if !flatBuffer.addToBatch(id: actualId, unlessUnchangedFrom: try cursor.get(actualId)) {
+                    didSkipPut()
+                }
+            } else {
+                flatBuffer.addToBatch(id: actualId)
+            }
+            flatBuffer.isCollecting = false
+
+            binding.setEntityIdUnlessStruct(of: entity, to: actualId)
+            pending.append((index: index, entity: entity, id: actualId, isNew: isNew))
+            if pending.count >= batchSize {
+                try flush()
+            }
+        }
+        if !pending.isEmpty {
+            try flush()
+        }
+    }
+
+    /// Puts the given entities in a new (or the enclosing) write transaction via `putBatched()`, or via
+    /// `putEncodedInParallel()` if `encodesPutsInParallel` applies.
+    internal func putCollection<C: Collection>(_ entities: C, mode: PutMode,
+                                               didPut: (_ index: Int, _ entity: EntityType, _ id: Id) throws -> Void)
+        throws where C.Element == EntityType {
+        let binding = EntityType.entityBinding
+        var newIds = ReservedIds(cBox: cBox, for: entities, binding: binding)
+        if encodesPutsInParallel && !skipsUnchangedPuts,
+           try putEncodedInParallel(entities, binding: binding, mode: mode, newIds: &newIds, didPut: didPut) {
+            return
+        }
+        newIds.rewind()  // Nothing was put, so IDs already taken by putEncodedInParallel() are still unused
+        try store.obx_runInTransaction(writable: true, { swiftTx in
+            let flatBuffer = FlatBufferBuilder.dequeue()
+            defer { FlatBufferBuilder.return(flatBuffer) }
+
+            let cursor = try Cursor<EntityType>(transaction: swiftTx)
+
+            try putBatched(entities, binding: binding, flatBuffer: flatBuffer, mode: mode, cursor: cursor,
+                           newIds: &newIds, didPut: didPut)
+        })
+    }
+
+    /// Minimum number of objects serialized by one thread, see `encodesPutsInParallel`.
+    internal static var parallelPutChunkSize: Int { return 500 }
+
+    /// Serializes the entities into one builder batch per chunk, with a thread per chunk, and then puts the batches
+    /// in a write transaction. Relations are written via `postPut()` and `didPut` is called after each batch.
+    /// The batches of all chunks are kept until the write transaction, see `encodesPutsInParallel`.
+    /// - Returns: false if nothing was put, because there are too few entities or processors, or because an entity
+    ///   has a to-one relation to an object that was not put yet (which can only be put in the write transaction).
+    private func putEncodedInParallel<C: Collection>(_ entities: C, binding: EntityType.EntityBindingType,
+                                                     mode: PutMode, newIds: inout ReservedIds,
+                                                     didPut: (_ index: Int, _ entity: EntityType, _ id: Id) throws
+                                                         -> Void) throws -> Bool
+        where C.Element == EntityType {
+        let chunkCount = Swift.min(ProcessInfo.processInfo.activeProcessorCount,
+                                   entities.count / Box.parallelPutChunkSize)
+        guard chunkCount > 1 else { return false }
+
+        let objects = ContiguousArray(entities)
+        let ids = try idsForPut(objects, binding: binding, newIds: &newIds)
+        let chunkSize = (objects.count + chunkCount - 1) / chunkCount
+        let chunks = (0 ..< chunkCount).map { $0 * chunkSize ..< Swift.min(objects.count, ($0 + 1) * chunkSize) }
+        let flatBuffers = chunks.map { _ in FlatBufferBuilder() }
+        var errors = [Swift.Error?](repeating: nil, count: chunkCount)
+        errors.withUnsafeMutableBufferPointer { chunkErrors in
+            DispatchQueue.concurrentPerform(iterations: chunkCount) { chunk in
+                let flatBuffer = flatBuffers[chunk]
+                flatBuffer.putsRelationTargets = false
+                do {
+                    for index in chunks[chunk] {
+                        flatBuffer.isCollecting = true
+                        flatBuffer.start(entitySchemaId: EntityType.entityInfo.entitySchemaId)
+                        try binding.collect(fromEntity: objects[index], id: ids[index], propertyCollector: flatBuffer,
+                                            store: store)
+                        flatBuffer.ensureStarted()
+                        flatBuffer.addToBatch(id: ids[index])
+                        flatBuffer.isCollecting = false
+                    }
+                } catch {
+                    chunkErrors[chunk] = error
+                }
+            }
+        }
+        if errors.contains(where: { $0 is FlatBufferBuilder.RelationTargetNotPut }) {
+            return false
+        }
+        if let error = errors.lazy.compactMap({ $0 }).first {
+            throw error
+        }
+
+        try store.obx_runInTransaction(writable: true, { swiftTx in
+            let cursor = try Cursor<EntityType>(transaction: swiftTx)
+            for (chunk, flatBuffer) in flatBuffers.enumerated() {
+                try cursor.putBatch(flatBuffer, mode: mode)
+                for index in chunks[chunk] {
+                    try binding.postPut(fromEntity: objects[index], id: ids[index], store: store)
+                    try didPut(index, objects[index], ids[index])
+                }
+            }
+        })
+        return true
+    }
+
+    /// The IDs to put the given objects with: their own IDs, or for new objects, IDs reserved in the objects' order.
+    /// A new class instance contained several times gets a single ID, like with `putBatched()`, which sets the ID of
+    /// an object before the next one is collected.
+    private func idsForPut(_ objects: ContiguousArray<EntityType>, binding: EntityType.EntityBindingType,
+                           newIds: inout ReservedIds) throws -> [Id] {
+        guard EntityType.self is AnyClass else {
+            return try objects.map { try newIds.id(for: $0, binding: binding) }
+        }
+        var idsOfNewInstances = [ObjectIdentifier: Id]()
+        return try objects.map { object in
+            guard binding.entityId(of: object) == 0 else { return try newIds.id(for: object, binding: binding) }
+            let instance = ObjectIdentifier(object as AnyObject)
+            if let id = idsOfNewInstances[instance] {
+                return id
+            }
+            let id = try newIds.next()
+            idsOfNewInstances[instance] = id
+            return id
+        }
+    }
+
     /// Puts the given entities in a box using a single transaction. Any entities that hadn't been persisted yet will be
     /// assigned an ID. For classes, the entity's ID property will be set to match any newly-assigned IDs.
     /// For structs, use the `put(inout [EntityType])` variant or extract the IDs from the returned array of
@@ -187,23 +415,13 @@ extension Box {
             // swiftlint:disable opening_brace
             let result = try [EntityType.EntityBindingType.IdType](unsafeUninitializedCapacity: entities.count)
             { ptr, initializedCount in
-                try store.obx_runInTransaction(writable: true, { swiftTx in
-                    let binding = EntityType.entityBinding
-                    let flatBuffer = FlatBufferBuilder.dequeue()
-                    defer { FlatBufferBuilder.return(flatBuffer) }
-
-                    let cursor = try Cursor<EntityType>(transaction: swiftTx)
-
-                    initializedCount = 0
-                    for entity in entities {
-                        let writtenId = try putOne(entity, binding: binding, flatBuffer: flatBuffer,
-                                                   mode: mode, cursor: cursor)
-                        try binding.postPut(fromEntity: entity, id: writtenId, store: store)
-                        binding.setEntityIdUnlessStruct(of: entity, to: writtenId)
-                        ptr[initializedCount] = EntityType.EntityBindingType.IdType(writtenId)
-                        initializedCount += 1
-                    }
-                })
+                let binding = EntityType.entityBinding
+                initializedCount = 0
+                try putCollection(entities, mode: mode) { index, entity, writtenId in
+                    binding.setEntityIdUnlessStruct(of: entity, to: writtenId)
+                    ptr[index] = EntityType.EntityBindingType.IdType(writtenId)
+                    initializedCount += 1
+                }
             }
             // swiftlint:enable opening_brace
             return result
@@ -222,20 +440,10 @@ extension Box {
             // Short-cut, we don't need a TX
             return
         }
-        try store.obx_runInTransaction(writable: true, { swiftTx in
-            let binding = EntityType.entityBinding
-            let flatBuffer = FlatBufferBuilder.dequeue()
-            defer { FlatBufferBuilder.return(flatBuffer) }
-
-            let cursor = try Cursor<EntityType>(transaction: swiftTx)
-
-            for entity in entities {
-                let writtenId = try putOne(entity, binding: binding, flatBuffer: flatBuffer,
-                                           mode: mode, cursor: cursor)
-                try binding.postPut(fromEntity: entity, id: writtenId, store: store)
-                binding.setEntityIdUnlessStruct(of: entity, to: writtenId)
-            }
-        })
+        let binding = EntityType.entityBinding
+        try putCollection(entities, mode: mode) { _, entity, writtenId in
+            binding.setEntityIdUnlessStruct(of: entity, to: writtenId)
+        }
     }
 
     /// :nodoc:
@@ -244,20 +452,10 @@ extension Box {
             // Short-cut, we don't need a TX
             return
         }
-        try store.obx_runInTransaction(writable: true, { swiftTx in
-            let binding = EntityType.entityBinding
-            let flatBuffer = FlatBufferBuilder.dequeue()
-            defer { FlatBufferBuilder.return(flatBuffer) }
-
-            let cursor = try Cursor<EntityType>(transaction: swiftTx)
-
-            for entity in entities {
-                let writtenId = try putOne(entity, binding: binding, flatBuffer: flatBuffer,
-                                           mode: mode, cursor: cursor)
-                try binding.postPut(fromEntity: entity, id: writtenId, store: store)
-                binding.setEntityIdUnlessStruct(of: entity, to: writtenId)
-            }
-        })
+        let binding = EntityType.entityBinding
+        try putCollection(entities, mode: mode) { _, entity, writtenId in
+            binding.setEntityIdUnlessStruct(of: entity, to: writtenId)
+        }
     }
 
     /// Version of put([EntityType]) that is faster because it uses ContiguousArray.
@@ -266,20 +464,10 @@ extension Box {
             // Short-cut, we don't need a TX
             return
         }
-        try store.obx_runInTransaction(writable: true, { swiftTx in
-            let binding = EntityType.entityBinding
-            let flatBuffer = FlatBufferBuilder.dequeue()
-            defer { FlatBufferBuilder.return(flatBuffer) }
-
-            let cursor = try Cursor<EntityType>(transaction: swiftTx)
-
-            for entity in entities {
-                let writtenId = try putOne(entity, binding: binding, flatBuffer: flatBuffer,
-                                           mode: mode, cursor: cursor)
-                try binding.postPut(fromEntity: entity, id: writtenId, store: store)
-                binding.setEntityIdUnlessStruct(of: entity, to: writtenId)
-            }
-        })
+        let binding = EntityType.entityBinding
+        try putCollection(entities, mode: mode) { _, entity, writtenId in
+            binding.setEntityIdUnlessStruct(of: entity, to: writtenId)
+        }
     }
 
 
@@ -295,21 +483,11 @@ extension Box {
             // Short-cut, we don't need a TX
             return
         }
-        try store.obx_runInTransaction(writable: true, { swiftTx in
-            let binding = EntityType.entityBinding
-            let flatBuffer = FlatBufferBuilder.dequeue()
-            defer { FlatBufferBuilder.return(flatBuffer) }
-
-            let cursor = try Cursor<EntityType>(transaction: swiftTx)
-
-            for entityIndex in 0 ..< entities.count {
-                let newEntity = entities[entityIndex]
-                let writtenId = try putOne(newEntity, binding: binding, flatBuffer: flatBuffer,
-                                           mode: mode, cursor: cursor)
-                try binding.postPut(fromEntity: newEntity, id: writtenId, store: store)
-                binding.setStructEntityId(of: &entities[entityIndex], to: writtenId)
-            }
-        })
+        let binding = EntityType.entityBinding
+        let entitiesToPut = entities
+        try putCollection(entitiesToPut, mode: mode) { entityIndex, _, writtenId in
+            binding.setStructEntityId(of: &entities[entityIndex], to: writtenId)
+        }
     }
 
     /// Puts the given entities in a box using a single transaction. Any entities that hadn't been persisted yet will be
@@ -334,6 +512,68 @@ extension Box {
     public func put(_ entities: EntityType..., mode: PutMode = .put) throws {
         try put(entities, mode: mode)
     }
+
+    /// Updates scalar properties (e.g. counters or status flags) of a stored object without collecting all of its
+    /// properties again. The new values are set in place in a copy of the stored object, which is then put.
+    /// Only if a property is absent in the stored object (e.g. it is nil, or was added to the model afterwards),
+    /// the object is read and collected again, including the new values.
+    ///
+    ///     try box.update(id: noteId) { patch in
+    ///         patch.set(Note.viewCount, to: 42)
+    ///     }
+    ///
+    /// - Parameter id: ID of the object to update.
+    /// - Parameter patch: Sets the new values; called once before the update transaction starts.
+    /// - Returns: false if there is no object with the given ID (nothing is written); true otherwise.
+    /// - Throws: ObjectBoxError errors for database write errors.
+    @discardableResult
+    public func update<I: IdBase>(id: I, _ patch: (EntityPatch<EntityType>) throws -> Void) throws -> Bool {
+        let entityPatch = EntityPatch<EntityType>()
+        try patch(entityPatch)
+        let changes = entityPatch.changes
+
+        let binding = EntityType.entityBinding
+        let flatBuffer = FlatBufferBuilder.dequeue()
+        defer { FlatBufferBuilder.return(flatBuffer) }
+
+        return try store.obx_runInTransaction(writable: true, { swiftTx -> Bool in
+            let cursor = try Cursor<EntityType>(transaction: swiftTx)
+            let stored = try cursor.get(id.value)
+            guard stored.data != nil else { return false }
+            if changes.isEmpty { return true }
+
+            if let patched = flatBuffer.patch(stored, changes: changes) {
+                try cursor.put(id: id.value, data: patched, mode: .update)
+            } else {
+                try rebuild(stored, id: id.value, changes: changes, binding: binding, flatBuffer: flatBuffer,
+                            cursor: cursor)
+            }
+            return true
+        })
+    }
+
+    /// Collects the stored object again along with the changed values; used if patching in place is not possible.
+    private func rebuild(_ stored: OBX_bytes, id: Id, changes: [PropertyPatch], binding: EntityType.EntityBindingType,
+                         flatBuffer: FlatBufferBuilder, cursor: Cursor<EntityType>) throws {
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(stored.data)
+        let entity = binding.createEntity(entityReader: reader, store: store)
+
+        flatBuffer.isCollecting = true
+        defer { flatBuffer.clear(); flatBuffer.isCollecting = false }
+        flatBuffer.start(entitySchemaId: EntityType.entityInfo.entitySchemaId)
+        try binding.collect(fromEntity: entity, id: id, propertyCollector: flatBuffer, store: store)
+        for change in changes where !flatBuffer.isCollected(at: change.propertyOffset) {
+            change.collect(into: flatBuffer)
+        }
+        flatBuffer.ensureStarted()
+        let collected = try flatBuffer.finish()
+        // Values that were collected from the entity are still the old ones; all are present now
+        guard let patched = flatBuffer.patch(collected, changes: changes) else {
+            throw ObjectBoxError.illegalState(message: "Could not set the changed values of object \(id)")
+        }
+        try cursor.put(id: id, data: patched, mode: .update)
+    }
 }
 
 // MARK: Reading Objects
@@ -390,6 +630,12 @@ extension Box {
     public func get<I: IdBase, C: Collection>(_ ids: C, maxCount: Int = 0)
     throws -> [EntityType] where C.Element == I {
 
+        if maxCount == 0 && ids.count >= Box.sortedGetMinimumCount {
+            var entities = [EntityType?](repeating: nil, count: ids.count)
+            try getSorted(ids) { index, entity in entities[index] = entity }
+            return entities.compactMap { $0 }
+        }
+
         var result: [EntityType] = []
         result.reserveCapacity(maxCount > 0 ? maxCount : ids.count)
 
@@ -441,6 +687,12 @@ extension Box {
                     -> [I: EntityType] where C.Element == I {
         var result = [I: EntityType](minimumCapacity: ids.count)
 
+        if ids.count >= Box.sortedGetMinimumCount {
+            let idArray = ContiguousArray(ids)
+            try getSorted(idArray) { index, entity in result[idArray[index]] = entity }
+            return result
+        }
+
         let binding = EntityType.entityBinding
         var flatBuffer = FlatBufferReader()
         try store.runInReadOnlyTransaction {
@@ -457,6 +709,30 @@ extension Box {
         return result
     }
 
+    /// Minimum number of IDs to get objects for in ID order, see `getSorted(_:_:)`.
+    internal static var sortedGetMinimumCount: Int { return 16 }
+
+    /// Gets the objects for the given IDs in ascending ID order using a single cursor. Unlike looking up IDs in random
+    /// order, this keeps consecutive lookups on the same (cached) B-tree pages. Objects are created one at a time, so
+    /// memory use is bounded unlike with obx_box_get_many(), which first copies the data of all objects.
+    /// - Parameter found: called with the index of the ID in `ids` and its object; not called for missing objects.
+    private func getSorted<C: Collection>(_ ids: C, _ found: (_ index: Int, _ entity: EntityType) -> Void) throws
+        where C.Element: IdBase {
+        var sortedIds = ContiguousArray(ids.enumerated().lazy.map { (id: $0.element.value, index: $0.offset) })
+        sortedIds.sort { $0.id < $1.id }
+
+        let binding = EntityType.entityBinding
+        var flatBuffer = FlatBufferReader()
+        try store.obx_runInTransaction(writable: false, { swiftTx in
+            let cursor = try Cursor<EntityType>(transaction: swiftTx)
+            for entry in sortedIds {
+                guard let data = try cursor.get(entry.id).data else { continue }
+                flatBuffer.setCurrentlyReadTableBytes(data)
+                found(entry.index, binding.createEntity(entityReader: flatBuffer, store: store))
+            }
+        })
+    }
+
     /// Gets all objects from the box.
     /// - Throws: ObjectBoxError
     /// - Returns: All stored Objects in this Box.
@@ -515,6 +791,10 @@ extension Box {
         // Seems it tries to deinit the uninitialized memory on assignment. Can't use init(repeating:) either as
         // empty user-defined entities may be expensive to create.
         try store.obx_runInTransaction(writable: false, { _ in
+            if let entities = createEntitiesInParallel(count: bytesArray.count, data: { bytesArray.bytes[$0].data }) {
+                result.append(contentsOf: entities)
+                return
+            }
             for dataIndex in 0 ..< bytesArray.count {
                 flatBuffer.setCurrentlyReadTableBytes(bytesArray.bytes[dataIndex].data)
                 let entity = binding.createEntity(entityReader: flatBuffer, store: store)
@@ -534,6 +814,10 @@ extension Box {
         // Seems it tries to deinit the uninitialized memory on assignment. Can't use init(repeating:) either as
         // empty user-defined entities may be expensive to create.
         try store.obx_runInTransaction(writable: false, { _ in
+            if let entities = createEntitiesInParallel(count: bytesArray.count, data: { bytesArray.bytes[$0].data }) {
+                result.append(contentsOf: entities)
+                return
+            }
             for dataIndex in 0 ..< bytesArray.count {
                 flatBuffer.setCurrentlyReadTableBytes(bytesArray.bytes[dataIndex].data)
                 let entity = binding.createEntity(entityReader: flatBuffer, store: store)
@@ -554,6 +838,12 @@ extension Box {
         // Seems it tries to deinit the uninitialized memory on assignment. Can't use init(repeating:) either as
         // empty user-defined entities may be expensive to create.
         try store.obx_runInTransaction(writable: false, { _ in
+            if let objects = createEntitiesInParallel(count: count, data: { bytesScoreArray.bytes_scores[$0].data }) {
+                for (dataIndex, object) in objects.enumerated() {
+                    result.append(ObjectWithScore(object: object, score: bytesScoreArray.bytes_scores[dataIndex].score))
+                }
+                return
+            }
             for dataIndex in 0 ..< count {
                 let item = bytesScoreArray.bytes_scores[dataIndex]
                 let score = item.score
@@ -564,6 +854,44 @@ extension Box {
         })
         return result
     }
+
+    /// Minimum number of objects created by one thread, see `decodesReadsInParallel`.
+    internal static var parallelReadChunkSize: Int { return 1_000 }
+
+    /// Creates the objects for the given data with a thread per chunk, each into its own pre-sized buffer, and then
+    /// concatenates the buffers in order. Must be called in the read transaction the data belongs to, which stays open
+    /// on the calling thread while the other threads only read the (immutable) data.
+    /// - Returns: nil if `decodesReadsInParallel` is disabled or there are too few objects or processors.
+    private func createEntitiesInParallel(count: Int, data: (_ index: Int) -> UnsafeRawPointer?)
+        -> ContiguousArray<EntityType>? {
+        guard decodesReadsInParallel else { return nil }
+        let chunkCount = Swift.min(ProcessInfo.processInfo.activeProcessorCount, count / Box.parallelReadChunkSize)
+        guard chunkCount > 1 else { return nil }
+
+        let binding = EntityType.entityBinding
+        let chunkSize = (count + chunkCount - 1) / chunkCount
+        var chunkResults = [ContiguousArray<EntityType>](repeating: [], count: chunkCount)
+        chunkResults.withUnsafeMutableBufferPointer { results in
+            DispatchQueue.concurrentPerform(iterations: chunkCount) { chunk in
+                let indices = chunk * chunkSize ..< Swift.min(count, (chunk + 1) * chunkSize)
+                var entities = ContiguousArray<EntityType>()
+                entities.reserveCapacity(indices.count)
+                var flatBuffer = FlatBufferReader()
+                for index in indices {
+                    flatBuffer.setCurrentlyReadTableBytes(data(index))
+                    entities.append(binding.createEntity(entityReader: flatBuffer, store: store))
+                }
+                results[chunk] = entities
+            }
+        }
+
+        var result = ContiguousArray<EntityType>()
+        result.reserveCapacity(count)
+        for entities in chunkResults {
+            result.append(contentsOf: entities)
+        }
+        return result
+    }
 }
 
 // MARK: Visit
@@ -655,6 +983,32 @@ extension Box {
             }
         })
     }
+
+    /// Iterate over all objects in this box without creating objects, calling the given closure with a reader for the
+    /// data of each object; e.g. to read vector properties as `VectorView` without copying them:
+    ///
+    ///     try box.visitReaders { reader in
+    ///         if let vector: VectorView<Float> = reader.read(at: 2 + 2 * 3) { sum += vector.reduce(0, +) }
+    ///         return true
+    ///     }
+    ///
+    /// The reader (and views read from it) are only valid during the call of the closure.
+    /// - Parameter writable: By default the objects are traversed for read-only access.
+    ///                       If you want to write, enable this flag to makes the enclosing transaction writable.
+    /// - Parameter visitor: A closure that is called for each object in this box. Return true to keep going, false to
+    ///                      abort the loop. Exceptions thrown by the closure are re-thrown.
+    public func visitReaders(writable: Bool = false, _ visitor: (FlatBufferReader) throws -> Bool) throws {
+        try store.obx_runInTransaction(writable: writable, { swiftTx in
+            let cursor = try Cursor<EntityType>(transaction: swiftTx)
+            var reader = FlatBufferReader()
+            var currBytes = try cursor.first()
+            while let data = currBytes.data {
+                reader.setCurrentlyReadTableBytes(data)
+                if try !visitor(reader) { break }
+                currBytes = try cursor.next()
+            }
+        })
+    }
 }
 
 // MARK: Removing Objects
@@ -708,49 +1062,22 @@ extension Box {
     @discardableResult
     public func remove<C: Collection>(_ entities: C) throws -> UInt64
         where C.Element == EntityType {
-            var result: UInt64 = 0
-
-            try store.obx_runInTransaction(writable: true, { swiftTx in
-                let cursor = try Cursor<EntityType>(transaction: swiftTx)
-
-                for currEntity in entities where try cursor.remove(currEntity) {
-                    result += 1
-                }
-            })
-
-            return result
+            let binding = EntityType.entityBinding
+            return try removeMany(entities.lazy.map { binding.entityId(of: $0) })
     }
 
     /// :nodoc:
     @discardableResult
     public func remove(_ entities: [EntityType]) throws -> UInt64 {
-        var result: UInt64 = 0
-
-        try store.obx_runInTransaction(writable: true, { swiftTx in
-            let cursor = try Cursor<EntityType>(transaction: swiftTx)
-
-            for currEntity in entities where try cursor.remove(currEntity) {
-                result += 1
-            }
-        })
-
-        return result
+        let binding = EntityType.entityBinding
+        return try removeMany(entities.lazy.map { binding.entityId(of: $0) })
     }
 
     /// Version of remove() that is faster because it uses ContiguousArray.
     @discardableResult
     public func remove(_ entities: ContiguousArray<EntityType>) throws -> UInt64 {
-        var result: UInt64 = 0
-
-        try store.obx_runInTransaction(writable: true, { swiftTx in
-            let cursor = try Cursor<EntityType>(transaction: swiftTx)
-
-            for currEntity in entities where try cursor.remove(currEntity) {
-                result += 1
-            }
-        })
-
-        return result
+        let binding = EntityType.entityBinding
+        return try removeMany(entities.lazy.map { binding.entityId(of: $0) })
     }
 
     /// Removes (deletes) the given objects (passed as individual parameters) in a single transaction.
@@ -769,14 +1096,7 @@ extension Box {
     /// :nodoc:
     @discardableResult
     public func remove(_ entityIDs: [Id]) throws -> UInt64 {
-        var result: UInt64 = 0
-        try store.obx_runInTransaction(writable: true, { swiftTx in
-            let cursor = try Cursor<EntityType>(transaction: swiftTx)
-            for currId in entityIDs where try cursor.remove(currId.value) {
-                result += 1
-            }
-        })
-        return result
+        return try removeMany(entityIDs.lazy.map { $0.value })
     }
 
     /// Removes (deletes) the objects with the given IDs in a single transaction.
@@ -798,16 +1118,7 @@ extension Box {
     @discardableResult
     internal func remove<I: UntypedIdBase, C: Collection>(collection ids: C) throws -> UInt64
         where C.Element == I {
-            var result: UInt64 = 0
-
-            try store.obx_runInTransaction(writable: true, { swiftTx in
-                let cursor = try Cursor<EntityType>(transaction: swiftTx)
-                for currId in ids where try cursor.remove(currId.value) {
-                    result += 1
-                }
-            })
-
-            return result
+            return try removeMany(ids.lazy.map { $0.value })
     }
 
     /// Removes (deletes) the objects with the given IDs (passed as individual parameters) in a single
@@ -834,14 +1145,7 @@ extension Box {
     /// :nodoc:
     @discardableResult
     public func remove(_ entityIDs: [EntityId<EntityType>]) throws -> UInt64 {
-        var result: UInt64 = 0
-        try store.obx_runInTransaction(writable: true, { swiftTx in
-            let cursor = try Cursor<EntityType>(transaction: swiftTx)
-            for currId in entityIDs where try cursor.remove(currId.value) {
-                result += 1
-            }
-        })
-        return result
+        return try removeMany(entityIDs.lazy.map { $0.value })
     }
 
     /// Removes (deletes) the objects with the given IDs in a single transaction.
@@ -863,16 +1167,7 @@ extension Box {
     @discardableResult
     internal func remove<C: Collection>(collection entityIDs: C) throws -> UInt64
         where C.Element == EntityId<EntityType> {
-        var result: UInt64 = 0
-
-        try store.obx_runInTransaction(writable: true, { swiftTx in
-            let cursor = try Cursor<EntityType>(transaction: swiftTx)
-            for currId in entityIDs where try cursor.remove(currId.value) {
-                result += 1
-            }
-        })
-
-        return result
+        return try removeMany(entityIDs.lazy.map { $0.value })
     }
 
     /// Removes (deletes) the objects with the given IDs (passed as individual objects) in a single transaction.
@@ -889,6 +1184,37 @@ extension Box {
         return try remove(ids)
     }
 
+    /// Removes the objects with the given IDs with a single native call; IDs of 0 (objects not put yet) are skipped.
+    private func removeMany<S: Sequence>(_ ids: S) throws -> UInt64 where S.Element == Id {
+        var result: UInt64 = 0
+        try withSortedIdArray(ids.lazy.filter { $0 != 0 }) { cIds in
+            guard cIds.pointee.count > 0 else { return }
+            try checkLastError(obx_box_remove_many(cBox, cIds, &result))
+        }
+        return result
+    }
+
+    /// Passes the given IDs as an OBX_id_array in ascending order, so that native bulk operations walk the B-tree in
+    /// order instead of jumping between its pages. IDs are only sorted (and duplicates dropped) if they are not in
+    /// strictly ascending order already.
+    private func withSortedIdArray<S: Sequence>(_ ids: S, _ body: (UnsafePointer<OBX_id_array>) throws -> Void)
+        rethrows where S.Element == Id {
+        var idArray = ContiguousArray(ids)
+        if zip(idArray, idArray.dropFirst()).contains(where: { $0 >= $1 }) {
+            idArray.sort()
+            var uniqueCount = 0
+            for id in idArray where uniqueCount == 0 || idArray[uniqueCount - 1] != id {
+                idArray[uniqueCount] = id
+                uniqueCount += 1
+            }
+            idArray.removeLast(idArray.count - uniqueCount)
+        }
+        try idArray.withUnsafeMutableBufferPointer { buffer in
+            var cIds = OBX_id_array(ids: buffer.baseAddress, count: buffer.count)
+            try body(&cIds)
+        }
+    }
+
     /// Removes (deletes) **all** objects in a single transaction.
     ///
     /// - Returns: Count of items that were removed.
@@ -70,6 +70,7 @@ public class EntityBuilder<T> {
     throws -> PropertyBuilder {
         let err1 = obx_model_property(model, name, OBXPropertyType(UInt32(type.rawValue)), id, uid)
         try checkLastError(err1)
+        entityInfo.modelProperty(id: id, type: type)
         let err2 = obx_model_property_flags(model, flags.rawValue)
         try checkLastError(err2)
         // Index
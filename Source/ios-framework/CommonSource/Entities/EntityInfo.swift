@@ -17,15 +17,34 @@
 import Foundation
 
 /// Used by the code generator to associate a Swift class with its counterpart in the model of the ObjectBox database.
-public final class EntityInfo: Sendable {
+public final class EntityInfo: @unchecked Sendable {
     /// The name of the entity in the database (may differ from the Swift class name).
     public let entityName: String
     /// The local ID number assigned to this type of entity in the database.
     public let entitySchemaId: UInt32
+
+    private let dateNanoLock = DispatchSemaphore(value: 1)
+    /// Date properties stored as nanoseconds; their Swift type is Date like for milliseconds. Guarded by dateNanoLock.
+    private var dateNanoPropertyIds = Set<UInt32>()
     
     /// Create an EntityInfo for a class with the given name and ID in the database.
     public init(name entityName: String, id schemaId: UInt32) {
         self.entityName = entityName
         self.entitySchemaId = schemaId
     }
+
+    /// Called by `EntityBuilder` for each property of the model.
+    internal func modelProperty(id propertyId: UInt32, type: PropertyType) {
+        guard type == .dateNano else { return }
+        dateNanoLock.wait()
+        defer { dateNanoLock.signal() }
+        dateNanoPropertyIds.insert(propertyId)
+    }
+
+    /// Whether the given property has the type dateNano in the model of a store that was opened.
+    internal func isDateNano(propertyId: UInt32) -> Bool {
+        dateNanoLock.wait()
+        defer { dateNanoLock.signal() }
+        return dateNanoPropertyIds.contains(propertyId)
+    }
 }
@@ -0,0 +1,40 @@
+//
+// Copyright © 2026 ObjectBox Ltd. <https://objectbox.io>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// How a float vector property (e.g. an embedding) is stored.
+/// The quantized encodings trade precision for size, e.g. a 1536-dimensional embedding takes 6 KB as `float32`,
+/// 3 KB as `float16` and 1.5 KB as `int8`. Values are quantized when an object is put and converted back to
+/// `[Float]` when it is read.
+///
+/// Note: an HNSW index (see `HnswParams`) requires `float32`; use quantized encodings for vectors that are only stored,
+/// e.g. full-dimension embeddings for re-ranking the results of a nearest neighbor search.
+public enum VectorEncoding: UInt32 {
+    /// 4 bytes per dimension; no loss of precision.
+    case float32 = 0
+    /// IEEE half precision, 2 bytes per dimension; about 3 significant decimal digits, largest value 65504.
+    case float16 = 1
+    /// 1 byte per dimension plus 4 bytes per vector; each value is scaled by the vector's largest magnitude.
+    case int8 = 2
+
+    /// The number of bytes a vector with the given number of dimensions takes (not counting its FlatBuffers length).
+    public func byteCount(dimensions: Int) -> Int {
+        switch self {
+        case .float32: return 4 * dimensions
+        case .float16: return 2 * dimensions
+        case .int8: return 4 + dimensions
+        }
+    }
+}
@@ -0,0 +1,144 @@
+//
+// Copyright © 2026 ObjectBox Ltd. <https://objectbox.io>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import Foundation
+
+/// Collects new values for scalar properties of a stored object; see `Box.update(id:_:)`.
+///
+///     try box.update(id: noteId) { patch in
+///         patch.set(Note.viewCount, to: 42)
+///         patch.set(Note.isArchived, to: true)
+///     }
+public final class EntityPatch<E: EntityInspectable & __EntityRelatable> where E == E.EntityBindingType.EntityType {
+    internal private(set) var changes: [PropertyPatch] = []
+
+    internal init() {}
+
+    /// Sets the given scalar property (e.g. an integer, floating point, bool or date property) to the given value.
+    /// For high precision date properties (type dateNano), use `setNanos(_:to:)` instead.
+    public func set<V: EntityPropertyTypeConvertible>(_ property: Property<E, V, Void>, to value: V) {
+        checkDate(V.self, property.propertyId, isNanos: false)
+        add(property.propertyId, PropertyPatch.Value(value), isPrimaryKey: property.isPrimaryKey)
+    }
+
+    /// Sets the given optional scalar property to the given (non-nil) value.
+    /// For high precision date properties (type dateNano), use `setNanos(_:to:)` instead.
+    public func set<V: EntityPropertyTypeConvertible>(_ property: Property<E, V?, Void>, to value: V) {
+        checkDate(V.self, property.propertyId, isNanos: false)
+        add(property.propertyId, PropertyPatch.Value(value), isPrimaryKey: property.isPrimaryKey)
+    }
+
+    /// Sets the given high precision date property (type dateNano) to the given value.
+    public func setNanos(_ property: Property<E, Date, Void>, to value: Date) {
+        checkDate(Date.self, property.propertyId, isNanos: true)
+        add(property.propertyId, .int64(value.unixTimestampNanos), isPrimaryKey: property.isPrimaryKey)
+    }
+
+    /// Sets the given optional high precision date property (type dateNano) to the given value.
+    public func setNanos(_ property: Property<E, Date?, Void>, to value: Date) {
+        checkDate(Date.self, property.propertyId, isNanos: true)
+        add(property.propertyId, .int64(value.unixTimestampNanos), isPrimaryKey: property.isPrimaryKey)
+    }
+
+    /// Date properties are stored as milliseconds or nanoseconds, which the Swift type does not tell; so check the
+    /// model's type to not store a value with the wrong unit.
+    private func checkDate<V>(_ valueType: V.Type, _ propertyId: UInt32, isNanos: Bool) {
+        guard valueType == Date.self else { return }
+        let isDateNano = E.entityInfo.isDateNano(propertyId: propertyId)
+        precondition(isDateNano == isNanos, isDateNano
+                     ? "Property \(propertyId) of \(E.self) is a dateNano property; set it using setNanos(_:to:)"
+                     : "Property \(propertyId) of \(E.self) is a date property; set it using set(_:to:)")
+    }
+
+    private func add(_ propertyId: UInt32, _ value: PropertyPatch.Value, isPrimaryKey: Bool) {
+        precondition(!isPrimaryKey, "The ID of an object cannot be changed")
+        changes.append(PropertyPatch(propertyOffset: UInt16(2 + 2 * propertyId), value: value))
+    }
+}
+
+/// A new value for a scalar property, which is either set in place or collected when an object is rebuilt.
+internal struct PropertyPatch {
+    enum Value {
+        case bool(Bool)
+        case int8(Int8)
+        case int16(Int16)
+        case int32(Int32)
+        case int64(Int64)
+        case uint8(UInt8)
+        case uint16(UInt16)
+        case uint32(UInt32)
+        case uint64(UInt64)
+        case float(Float)
+        case double(Double)
+
+        // swiftlint:disable:next cyclomatic_complexity
+        init<V>(_ value: V) {
+            switch value {
+            case let value as Bool: self = .bool(value)
+            case let value as Int8: self = .int8(value)
+            case let value as Int16: self = .int16(value)
+            case let value as Int32: self = .int32(value)
+            case let value as Int64: self = .int64(value)
+            case let value as Int: self = .int64(Int64(value))
+            case let value as UInt8: self = .uint8(value)
+            case let value as UInt16: self = .uint16(value)
+            case let value as UInt32: self = .uint32(value)
+            case let value as UInt64: self = .uint64(value)
+            case let value as UInt: self = .uint64(UInt64(value))
+            case let value as Float: self = .float(value)
+            case let value as Double: self = .double(value)
+            case let value as Date: self = .int64(value.unixTimestamp)
+            default: fatalError("Only scalar properties can be patched; \(V.self) is not supported")
+            }
+        }
+    }
+
+    let propertyOffset: UInt16
+    let value: Value
+
+    /// Sets the value in the given (mutable) FlatBuffer; returns false if the property is absent in it.
+    func apply(to fbr: OpaquePointer) -> Bool {
+        switch value {
+        case .bool(let value): return obx_fbr_patch_bool(fbr, propertyOffset, value)
+        case .int8(let value): return obx_fbr_patch_int8(fbr, propertyOffset, value)
+        case .int16(let value): return obx_fbr_patch_int16(fbr, propertyOffset, value)
+        case .int32(let value): return obx_fbr_patch_int32(fbr, propertyOffset, value)
+        case .int64(let value): return obx_fbr_patch_int64(fbr, propertyOffset, value)
+        case .uint8(let value): return obx_fbr_patch_uint8(fbr, propertyOffset, value)
+        case .uint16(let value): return obx_fbr_patch_uint16(fbr, propertyOffset, value)
+        case .uint32(let value): return obx_fbr_patch_uint32(fbr, propertyOffset, value)
+        case .uint64(let value): return obx_fbr_patch_uint64(fbr, propertyOffset, value)
+        case .float(let value): return obx_fbr_patch_float(fbr, propertyOffset, value)
+        case .double(let value): return obx_fbr_patch_double(fbr, propertyOffset, value)
+        }
+    }
+
+    func collect(into flatBuffer: FlatBufferBuilder) {
+        switch value {
+        case .bool(let value): flatBuffer.collect(value, at: propertyOffset)
+        case .int8(let value): flatBuffer.collect(value, at: propertyOffset)
+        case .int16(let value): flatBuffer.collect(value, at: propertyOffset)
+        case .int32(let value): flatBuffer.collect(value, at: propertyOffset)
+        case .int64(let value): flatBuffer.collect(value, at: propertyOffset)
+        case .uint8(let value): flatBuffer.collect(value, at: propertyOffset)
+        case .uint16(let value): flatBuffer.collect(value, at: propertyOffset)
+        case .uint32(let value): flatBuffer.collect(value, at: propertyOffset)
+        case .uint64(let value): flatBuffer.collect(value, at: propertyOffset)
+        case .float(let value): flatBuffer.collect(value, at: propertyOffset)
+        case .double(let value): flatBuffer.collect(value, at: propertyOffset)
+        }
+    }
+}
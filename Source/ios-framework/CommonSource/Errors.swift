@@ -126,6 +126,16 @@ internal func checkLastErrorSuccessFlag(_ error: obx_err) throws -> Bool {
     }
 }
 
+/// Checks an ID returned by obx_cursor_id_for_put() or obx_box_id_for_put(), which is 0 if the given ID is invalid
+/// (e.g. above the box's ID sequence), and throws the error set by the call in that case.
+internal func checkIdForPut(_ id: Id) throws -> Id {
+    if id == 0 {
+        try checkLastError()
+        throw ObjectBoxError.illegalState(message: "Getting an ID for put failed, but no error was set")
+    }
+    return id
+}
+
 /// E.g. prints error
 func checkLastErrorNoThrow(_ error: obx_err) {
     if error == OBX_SUCCESS { return }
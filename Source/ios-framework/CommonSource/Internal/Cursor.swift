@@ -34,14 +34,18 @@ internal class Cursor<E: __EntityRelatable & EntityInspectable> where E == E.Ent
         obx_cursor_close(cCursor)
     }
     
-    func idForPut(_ entity: EntityType) -> Id {
-        return obx_cursor_id_for_put(cCursor, entityBinding.entityId(of: entity).value)
+    func idForPut(_ entity: EntityType) throws -> Id {
+        return try checkIdForPut(obx_cursor_id_for_put(cCursor, entityBinding.entityId(of: entity).value))
     }
     
     func put(id entityId: Id, data: OBX_bytes, mode: PutMode) throws {
         try checkLastError(obx_cursor_put4(cCursor, entityId, data.data, data.size, OBXPutMode(mode.rawValue)))
     }
     
+    func putBatch(_ flatBuffer: FlatBufferBuilder, mode: PutMode) throws {
+        try flatBuffer.putBatch(cursor: cCursor, mode: mode)
+    }
+
     func remove(_ entity: EntityType) throws -> Bool {
         let entityId = entityBinding.entityId(of: entity).value
         guard entityId != 0 else { return false }
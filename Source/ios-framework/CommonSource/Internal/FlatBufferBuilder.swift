@@ -20,6 +20,10 @@ import Foundation
 public class FlatBufferBuilder {
     private var fbb: OpaquePointer! /*OBX_fbb*/
 
+    // Reused by prepare(values: [String]) to pass all strings with a single call, see obx_fbb_prepare_strings_blob()
+    private var stringsBlob = ContiguousArray<UInt8>()
+    private var stringLengths = ContiguousArray<Int>()
+
     internal var isCollecting: Bool {
         get {
             return obx_fbb_is_collecting(fbb)
@@ -32,32 +36,64 @@ public class FlatBufferBuilder {
     internal var didStart: Bool {
         return obx_fbb_did_start(fbb)
     }
+
+    /// Memory statistics of the underlying builder, e.g. to check that steady-state puts do not allocate anymore.
+    internal var stats: OBX_fbb_stats {
+        var result = OBX_fbb_stats()
+        obx_fbb_stats(fbb, &result)
+        return result
+    }
     
+    /// Process-wide statistics of compressed strings and byte vectors, see `prepare(string:compressed:)`.
+    internal static var compressionStats: OBX_compression_stats {
+        var result = OBX_compression_stats()
+        obx_compression_stats(&result)
+        return result
+    }
+
+    /// Whether the native builder belongs to the thread's pool (see `dequeue()`) instead of this object.
+    private let isPooled: Bool
+
+    /// If false, collecting a to-one relation to an object that was not put yet throws `RelationTargetNotPut` instead
+    /// of putting the target; for collecting outside of a write transaction, see `Box.encodesPutsInParallel`.
+    internal var putsRelationTargets = true
+
+    internal struct RelationTargetNotPut: Error {}
+
     init() {
         fbb = obx_fbb_create()
+        isPooled = false
     }
-    
+
+    private init(pooled: OpaquePointer) {
+        fbb = pooled
+        isPooled = true
+    }
+
     deinit {
-        if fbb != nil {
+        if fbb != nil && !isPooled {
             obx_fbb_free(fbb)
         }
     }
-    
-    static let cachedFlatbuffer = ThreadSpecific<FlatBufferBuilder?>(initialValue: nil)
-    
+
+    /// Gets a builder from the current thread's native pool, which has a few builders for nested puts.
+    /// A pooled builder keeps its wrapper as owner, so the same wrapper is returned for it each time.
     internal class func dequeue() -> FlatBufferBuilder {
-        if let thisThreadsFlatbuffer = cachedFlatbuffer.value {
-            cachedFlatbuffer.value = nil
-            return thisThreadsFlatbuffer
-        } else {
-            return FlatBufferBuilder()
+        let pooled = obx_fbb_acquire()
+        if let owner = obx_fbb_owner(pooled) {
+            return Unmanaged<FlatBufferBuilder>.fromOpaque(owner).takeUnretainedValue()
+        }
+        let flatBuffer = FlatBufferBuilder(pooled: pooled)
+        obx_fbb_set_owner(pooled, Unmanaged.passRetained(flatBuffer).toOpaque()) { owner in
+            Unmanaged<FlatBufferBuilder>.fromOpaque(owner).release()
         }
+        return flatBuffer
     }
-    
+
+    /// Gives a builder obtained from `dequeue()` back to the current thread's pool; do not use it afterwards.
     internal class func `return`(_ flatBuffer: FlatBufferBuilder) {
-        if cachedFlatbuffer.value == nil {
-            cachedFlatbuffer.value = flatBuffer
-        }
+        guard flatBuffer.isPooled else { return }
+        obx_fbb_release(flatBuffer.fbb)
     }
     
     internal func finish() throws -> OBX_bytes {
@@ -66,15 +102,85 @@ public class FlatBufferBuilder {
         return bytes
     }
     
+    /// Whether the finished object equals the given stored object, e.g. from `Cursor.get()`; false if there is none.
+    internal func matches(_ stored: OBX_bytes) -> Bool {
+        guard let data = stored.data else { return false }
+        return obx_fbb_matches(fbb, data, stored.size)
+    }
+
     internal func ensureStarted() {
         obx_fbb_ensure_started(fbb)
     }
+
+    /// Tells the builder the entity type of the next object, so it can reserve the size learned for this type.
+    /// Call before collecting the object, i.e. after clearing the builder.
+    internal func start(entitySchemaId: UInt32) {
+        obx_fbb_start_entity(fbb, entitySchemaId)
+    }
+
+    /// The object sizes learned for the given entity type, see `start(entitySchemaId:)`.
+    internal static func sizeHint(entitySchemaId: UInt32) -> PutSizeHint? {
+        var hint = OBX_fbb_size_hint()
+        guard obx_fbb_size_hint(entitySchemaId, &hint) else { return nil }
+        return PutSizeHint(averageSize: hint.average_size, reservedSize: hint.reserve_size,
+                           objectCount: hint.object_count, reallocationCount: hint.reallocations)
+    }
     
     internal func clear() {
         obx_fbb_clear(fbb)
     }
 }
 
+// MARK: batch
+
+extension FlatBufferBuilder {
+    /// Finishes the collected object and appends it to the batch to be put with the given ID; clears the builder.
+    internal func addToBatch(id: Id) {
+        obx_fbb_batch_add(fbb, id)
+    }
+
+    /// Like `addToBatch(id:)`, but skips the object if it equals the given stored object (see `matches()`).
+    /// - Returns: false if the object was unchanged and thus not added.
+    internal func addToBatch(id: Id, unlessUnchangedFrom stored: OBX_bytes) -> Bool {
+        return obx_fbb_batch_add_changed(fbb, id, stored.data, stored.size)
+    }
+
+    internal var batchCount: Int {
+        return obx_fbb_batch_count(fbb)
+    }
+
+    /// Puts all batched objects with a single call into the native layer.
+    internal func putBatch(cursor: OpaquePointer, mode: PutMode) throws {
+        try checkLastError(obx_fbb_batch_put(fbb, cursor, OBXPutMode(mode.rawValue)))
+    }
+
+    internal func clearBatch() {
+        obx_fbb_batch_clear(fbb)
+    }
+}
+
+// MARK: patch
+
+extension FlatBufferBuilder {
+    /// Copies the given stored object into the builder's scratch buffer and sets the changed values in place.
+    /// - Returns: The patched object (builder-owned memory, valid until the next patch), or nil if a changed property
+    ///   is absent in the stored object and thus the object has to be collected again.
+    internal func patch(_ bytes: OBX_bytes, changes: [PropertyPatch]) -> OBX_bytes? {
+        guard let data = bytes.data, let fbr = obx_fbb_patch_start(fbb, data, bytes.size) else { return nil }
+        for change in changes where !change.apply(to: fbr) {
+            return nil
+        }
+        var patched = OBX_bytes()
+        obx_fbb_patch_get(fbb, &patched)
+        return patched
+    }
+
+    /// Whether a value was collected at the given offset for the object currently being collected.
+    internal func isCollected(at propertyOffset: UInt16) -> Bool {
+        return obx_fbb_is_collected(fbb, propertyOffset)
+    }
+}
+
 // MARK: collect
 
 public extension FlatBufferBuilder {
@@ -158,12 +264,41 @@ public extension FlatBufferBuilder {
     func collect(dataOffset: OBXDataOffset, at propertyOffset: UInt16) {
         obx_fbb_collect_data_offset(fbb, dataOffset, propertyOffset)
     }
-    
+
+    /// Take all scalar values of the given row struct and write them to the properties described by the layout,
+    /// using a single call.
+    /// - Parameter presence: Bitmap with one bit per layout property (see `FlatBufferRowLayout.presenceByteCount`);
+    ///   properties with a cleared bit are NULL and not written. Pass nil if all properties are present.
+    func collect(row: UnsafeRawPointer, layout: FlatBufferRowLayout, presence: UnsafePointer<UInt8>? = nil) {
+        layout.fields.withUnsafeBufferPointer { fields in
+            guard let fieldsStart = fields.baseAddress else { return }
+            obx_fbb_collect_row(fbb, fieldsStart, fields.count, row, presence)
+        }
+    }
+
+    /// Take all scalar values of the given row struct and write them to the properties described by the layout,
+    /// using a single call.
+    func collect<Row>(row: Row, layout: FlatBufferRowLayout, presence: [UInt8]? = nil) {
+        withUnsafeBytes(of: row) { rowBytes in
+            if let presence = presence {
+                assert(presence.count >= layout.presenceByteCount)
+                presence.withUnsafeBufferPointer { collect(row: rowBytes.baseAddress!, layout: layout,
+                                                           presence: $0.baseAddress) }
+            } else {
+                collect(row: rowBytes.baseAddress!, layout: layout)
+            }
+        }
+    }
+
     /// - returns: A value > 0 when a string value is prepared; 0 if the property is skipped.
     func prepare(string: String?) -> OBXDataOffset {
-        guard let string = string else { return 0 } // We just don't collect nil values.
-        return string.withCString { cString -> OBXDataOffset in
-            return obx_fbb_prepare_string(fbb, cString)
+        guard var string = string else { return 0 } // We just don't collect nil values.
+        // Native Swift strings are contiguous UTF-8 already; only bridged strings get copied to become contiguous
+        return string.withUTF8 { utf8 -> OBXDataOffset in
+            guard let start = utf8.baseAddress else { return obx_fbb_prepare_string_n(fbb, "", 0) }
+            return start.withMemoryRebound(to: CChar.self, capacity: utf8.count) {
+                obx_fbb_prepare_string_n(fbb, $0, utf8.count)
+            }
         }
     }
     
@@ -184,6 +319,43 @@ public extension FlatBufferBuilder {
             return obx_fbb_prepare_bytes(fbb, bytes.baseAddress!, size)
         }
     }
+
+    /// Like `prepare(string:)`, but stores large strings compressed if that saves enough space; the binding must read
+    /// the property via `FlatBufferReader.read(at:compressed:)` to decompress them. Queries see the compressed value,
+    /// so only use this for properties that are not queried or indexed.
+    /// - returns: A value > 0 when a string value is prepared; 0 if the property is skipped.
+    func prepare(string: String?, compressed: Bool) -> OBXDataOffset {
+        guard compressed else { return prepare(string: string) }
+        guard var string = string else { return 0 } // We just don't collect nil values.
+        return string.withUTF8 { utf8 -> OBXDataOffset in
+            guard let start = utf8.baseAddress else { return obx_fbb_prepare_string_n(fbb, "", 0) }
+            return start.withMemoryRebound(to: CChar.self, capacity: utf8.count) {
+                obx_fbb_prepare_string_compressed(fbb, $0, utf8.count)
+            }
+        }
+    }
+
+    /// Like `prepare(bytes:)`, but stores large data compressed; see `prepare(string:compressed:)`.
+    /// - returns: A value > 0 when a data value is prepared; 0 if the property is skipped.
+    func prepare(bytes data: Data?, compressed: Bool) -> OBXDataOffset {
+        guard compressed else { return prepare(bytes: data) }
+        guard let data = data else { return 0 } // We just don't collect nil values.
+        let size = data.count
+        return data.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) -> OBXDataOffset in
+            return obx_fbb_prepare_bytes_compressed(fbb, bytes.baseAddress!, size)
+        }
+    }
+
+    /// Like `prepare(bytes:)`, but stores large byte vectors compressed; see `prepare(string:compressed:)`.
+    /// - returns: A value > 0 when a data value is prepared; 0 if the property is skipped.
+    func prepare(bytes: [UInt8]?, compressed: Bool) -> OBXDataOffset {
+        guard compressed else { return prepare(bytes: bytes) }
+        guard let bytes = bytes else { return 0 } // We just don't collect nil values.
+        let size = bytes.count
+        return bytes.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) -> OBXDataOffset in
+            return obx_fbb_prepare_bytes_compressed(fbb, bytes.baseAddress!, size)
+        }
+    }
     
     func prepare(values: [Int32]?) -> OBXDataOffset {
         guard let values = values else { return 0 } // Don't collect nil values.
@@ -209,12 +381,161 @@ public extension FlatBufferBuilder {
         }
     }
 
+    /// Whether the given alignment is supported for vectors, i.e. a power of two from 1 to 256.
+    static func isValid(alignment: Int) -> Bool {
+        return alignment > 0 && alignment <= 256 && alignment & (alignment - 1) == 0
+    }
+
+    /// Like `prepare(values:)`, but places the floats at the given alignment (e.g. 16, 32 or 64 bytes), so SIMD code
+    /// can use aligned loads; see `FlatBufferReader.withFloats(at:alignment:_:)`.
+    /// Note: the whole FlatBuffer is then aligned to this as well, which pads it by up to `alignment - 1` bytes.
+    /// - Parameter alignment: a power of two from 1 to 256.
+    func prepare(values: [Float]?, alignment: Int) -> OBXDataOffset {
+        precondition(FlatBufferBuilder.isValid(alignment: alignment), "Alignment must be a power of two up to 256")
+        guard let values = values else { return 0 } // Don't collect nil values.
+        let size = values.count
+        return values.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) -> OBXDataOffset in
+            return obx_fbb_prepare_floats_aligned(fbb, bytes.baseAddress!, size, alignment)
+        }
+    }
+
+    /// Like `prepare(values:)`, but places the longs at the given alignment; see `prepare(values:alignment:)`.
+    func prepare(values: [Int64]?, alignment: Int) -> OBXDataOffset {
+        precondition(FlatBufferBuilder.isValid(alignment: alignment), "Alignment must be a power of two up to 256")
+        guard let values = values else { return 0 } // Don't collect nil values.
+        let size = values.count
+        return values.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) -> OBXDataOffset in
+            return obx_fbb_prepare_longs_aligned(fbb, bytes.baseAddress!, size, alignment)
+        }
+    }
+
+    /// Like `prepare(values:)`, but quantizes the floats using the given encoding, e.g. to store embeddings compactly.
+    /// Read the vector using `FlatBufferReader.read(at:encoding:)` with the same encoding.
+    func prepare(values: [Float]?, encoding: VectorEncoding) -> OBXDataOffset {
+        guard let values = values else { return 0 } // Don't collect nil values.
+        let size = values.count
+        return values.withUnsafeBufferPointer { (floats: UnsafeBufferPointer<Float>) -> OBXDataOffset in
+            return obx_fbb_prepare_floats_encoded(fbb, floats.baseAddress!, size, OBXVectorEncoding(encoding.rawValue))
+        }
+    }
+
+    func prepare(values: [Int16]?) -> OBXDataOffset {
+        guard let values = values else { return 0 } // Don't collect nil values.
+        let size = values.count
+        return values.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) -> OBXDataOffset in
+            return obx_fbb_prepare_shorts(fbb, bytes.baseAddress!, size)
+        }
+    }
+
+    /// For char vectors (16 bit characters).
+    func prepare(values: [UInt16]?) -> OBXDataOffset {
+        guard let values = values else { return 0 } // Don't collect nil values.
+        let size = values.count
+        return values.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) -> OBXDataOffset in
+            return obx_fbb_prepare_shorts(fbb, bytes.baseAddress!, size)
+        }
+    }
+
+    func prepare(values: [Double]?) -> OBXDataOffset {
+        guard let values = values else { return 0 } // Don't collect nil values.
+        let size = values.count
+        return values.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) -> OBXDataOffset in
+            return obx_fbb_prepare_doubles(fbb, bytes.baseAddress!, size)
+        }
+    }
+
+    /// Bool vectors are stored with one byte per value, which matches the memory layout of Swift's Bool.
+    func prepare(values: [Bool]?) -> OBXDataOffset {
+        guard let values = values else { return 0 } // Don't collect nil values.
+        let size = values.count
+        return values.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) -> OBXDataOffset in
+            return obx_fbb_prepare_bytes(fbb, bytes.baseAddress!, size)
+        }
+    }
+
+    /// Date vectors are stored as milliseconds since 1970-01-01 (unix epoch), like single date properties.
+    func prepare(values: [Date]?) -> OBXDataOffset {
+        guard let values = values else { return 0 } // Don't collect nil values.
+        return prepare(values: values.map { $0.unixTimestamp })
+    }
+
+    /// High precision date vectors are stored as nanoseconds since 1970-01-01 (unix epoch).
+    func prepareNanos(values: [Date]?) -> OBXDataOffset {
+        guard let values = values else { return 0 } // Don't collect nil values.
+        return prepare(values: values.map { $0.unixTimestampNanos })
+    }
+
     func prepare(values: [String]?) -> OBXDataOffset {
         guard let values = values else { return 0 } // Don't collect nil values.
-        return Util.withArrayOfCStrings(values) { cStrings, count in
-            // withArrayOfCStrings guarantees a valid pointer even for empty arrays
-            let ptr = UnsafeRawPointer(cStrings).assumingMemoryBound(to: UnsafePointer<CChar>.self)
-            return obx_fbb_prepare_strings(fbb, ptr, count)
+        // Concatenate the UTF-8 of all strings into one blob; no nesting of withCString closures
+        stringsBlob.removeAll(keepingCapacity: true)
+        stringLengths.removeAll(keepingCapacity: true)
+        stringLengths.reserveCapacity(values.count + 1)
+        for value in values {
+            stringsBlob.append(contentsOf: value.utf8)
+            stringLengths.append(value.utf8.count)
+        }
+        // Never empty, so there are always valid pointers (not part of any string)
+        stringsBlob.append(0)
+        stringLengths.append(0)
+        let count = values.count
+        return stringsBlob.withUnsafeBytes { blob -> OBXDataOffset in
+            stringLengths.withUnsafeBufferPointer { lengths -> OBXDataOffset in
+                obx_fbb_prepare_strings_blob(fbb, blob.baseAddress!.assumingMemoryBound(to: CChar.self),
+                                             lengths.baseAddress!, count)
+            }
+        }
+    }
+
+    /// Encodes the value using the FlexBuffers format, e.g. for flex, flexMap and flexVector properties.
+    /// - returns: A value > 0 when a flex value is prepared; 0 if the property is skipped.
+    func prepare(flex value: FlexValue?) -> OBXDataOffset {
+        guard let value = value else { return 0 } // Don't collect nil values.
+        addFlex(value)
+        return obx_fbb_flex_finish(fbb)
+    }
+
+    private func addFlex(_ value: FlexValue) {
+        switch value {
+        case .null:
+            obx_fbb_flex_null(fbb)
+        case .bool(let bool):
+            obx_fbb_flex_bool(fbb, bool)
+        case .int(let int):
+            obx_fbb_flex_int(fbb, int)
+        case .uint(let uint):
+            obx_fbb_flex_uint(fbb, uint)
+        case .double(let double):
+            obx_fbb_flex_double(fbb, double)
+        case .string(let string):
+            withFlexUTF8(string) { obx_fbb_flex_string(fbb, $0, $1) }
+        case .blob(let data):
+            data.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) in
+                guard let start = bytes.baseAddress else { return obx_fbb_flex_blob(fbb, "", 0) }
+                obx_fbb_flex_blob(fbb, start, bytes.count)
+            }
+        case .vector(let elements):
+            obx_fbb_flex_vector_start(fbb)
+            for element in elements {
+                addFlex(element)
+            }
+            obx_fbb_flex_vector_end(fbb)
+        case .map(let entries):
+            obx_fbb_flex_map_start(fbb)
+            // The native builder sorts the map; adding keys in that order too keeps the buffer bytes deterministic
+            for (key, element) in entries.sorted(by: { $0.key.utf8.lexicographicallyPrecedes($1.key.utf8) }) {
+                withFlexUTF8(key) { obx_fbb_flex_key(fbb, $0, $1) }
+                addFlex(element)
+            }
+            obx_fbb_flex_map_end(fbb)
+        }
+    }
+
+    private func withFlexUTF8(_ string: String, _ body: (UnsafePointer<CChar>, Int) -> Void) {
+        var string = string
+        string.withUTF8 { utf8 in
+            guard let start = utf8.baseAddress else { return body("", 0) }
+            start.withMemoryRebound(to: CChar.self, capacity: utf8.count) { body($0, utf8.count) }
         }
     }
 
@@ -322,6 +643,7 @@ public extension FlatBufferBuilder {
         guard toOne.hasValue else { return }
         var targetId = toOne.targetId?.value
         if targetId == nil {  // TODO move this before collecting: putting is a surprising thing to do here
+            guard putsRelationTargets else { throw RelationTargetNotPut() }
             let relatedBox = store.box(for: type(of: toOne).Target.self)
             guard let target = toOne.target else {
                 fatalError("Internal error: to-one target has neither id nor entity")
@@ -332,3 +654,17 @@ public extension FlatBufferBuilder {
         self.collect(targetId!.value, at: propertyOffset)
     }
 }
+
+/// Object sizes learned when putting objects of an entity type; used to reserve buffer space up front, so that
+/// serializing large objects does not have to grow (and copy) the buffer repeatedly. See `Box.putSizeHint`.
+public struct PutSizeHint {
+    /// Moving average of the serialized sizes of put objects.
+    public let averageSize: Int
+    /// The buffer size reserved before serializing an object (the average plus some headroom).
+    public let reservedSize: Int
+    /// Number of objects the average was learned from.
+    public let objectCount: UInt64
+    /// Number of times a buffer had to grow while serializing an object, e.g. before a size was learned;
+    /// does not increase anymore once the learned size fits the objects.
+    public let reallocationCount: UInt64
+}
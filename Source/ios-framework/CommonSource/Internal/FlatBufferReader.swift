@@ -20,14 +20,18 @@ import Foundation
 /// Used by generated Swift code to hydrate an entity from the store.
 public struct FlatBufferReader {
     private var fbr: OpaquePointer? /*OBX_fbr*/
+    /// The same table as fbr; scalars are read from it in Swift, so the optimizer can inline them into generated code.
+    @usableFromInline internal var table: UnsafeRawPointer?
     
     /// The pointer passed to setCurrentlyReadTableBytes must stay valid until you've finished calling into the
     /// FlatBufferReader.
     internal mutating func setCurrentlyReadTableBytes(_ newValue: UnsafeRawPointer?) {
         if let newValue = newValue {
             fbr = obx_fbr_get_root(newValue)
+            table = UnsafeRawPointer(fbr)
         } else {
             fbr = nil
+            table = nil
         }
     }
     
@@ -35,134 +39,137 @@ public struct FlatBufferReader {
         guard let fbr = fbr else { fatalError("Must call setCurrentlyReadTableBytes() before calling read(at:).") }
         return fbr
     }
+
+    /// Address of the given field in the table, or nil if it is absent; like flatbuffers::Table::GetAddressOf(), which
+    /// the obx_fbr_read_* functions use. The table starts with the (signed) offset back to its vtable, which starts
+    /// with its own size; fields beyond it or with a zero offset are absent. Tables are only read from objects that
+    /// ObjectBox stored (and thus verified), so only the field's vtable entry must be checked against the vtable size.
+    @inlinable @inline(__always)
+    internal func fieldAddress(at propertyOffset: UInt16) -> UnsafeRawPointer? {
+        guard let table = table else { fatalError("Must call setCurrentlyReadTableBytes() before calling read(at:).") }
+        let vtable = table - Int(table.loadUnaligned(as: Int32.self))
+        let vtableSize = Int(vtable.loadUnaligned(as: UInt16.self))
+        guard Int(propertyOffset) + MemoryLayout<UInt16>.size <= vtableSize else { return nil }
+        let fieldOffset = vtable.loadUnaligned(fromByteOffset: Int(propertyOffset), as: UInt16.self)
+        return fieldOffset == 0 ? nil : table + Int(fieldOffset)
+    }
+
+    /// Reads a scalar field (FlatBuffers are little endian like all Apple platforms); nil if it is absent.
+    @inlinable @inline(__always)
+    internal func readScalar<T>(at propertyOffset: UInt16) -> T? {
+        return fieldAddress(at: propertyOffset)?.loadUnaligned(as: T.self)
+    }
     
     /// - Returns: false if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
+    @inlinable
     public func read(at index: UInt16) -> Bool {
-        var result: Bool = false
-        _ = obx_fbr_read_bool(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return result
+        return (readScalar(at: index) as UInt8? ?? 0) != 0
     }
     
     /// - Returns: 0 if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
+    @inlinable
     public func read(at index: UInt16) -> Int8 {
-        var result: Int8 = 0
-        _ = obx_fbr_read_int8(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return result
+        return readScalar(at: index) ?? 0
     }
     
     /// - Returns: 0 if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
+    @inlinable
     public func read(at index: UInt16) -> Int16 {
-        var result: Int16 = 0
-        _ = obx_fbr_read_int16(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return result
+        return readScalar(at: index) ?? 0
     }
     
     /// - Returns: 0 if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
+    @inlinable
     public func read(at index: UInt16) -> Int32 {
-        var result: Int32 = 0
-        _ = obx_fbr_read_int32(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return result
+        return readScalar(at: index) ?? 0
     }
     
     /// - Returns: 0 if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
+    @inlinable
     public func read(at index: UInt16) -> Int64 {
-        var result: Int64 = 0
-        _ = obx_fbr_read_int64(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return result
+        return readScalar(at: index) ?? 0
     }
     
     /// - Returns: 0 if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
+    @inlinable
     public func read(at index: UInt16) -> UInt8 {
-        var result: UInt8 = 0
-        _ = obx_fbr_read_uint8(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return result
+        return readScalar(at: index) ?? 0
     }
     
     /// - Returns: 0 if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
+    @inlinable
     public func read(at index: UInt16) -> UInt16 {
-        var result: UInt16 = 0
-        _ = obx_fbr_read_uint16(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return result
+        return readScalar(at: index) ?? 0
     }
     
     /// - Returns: 0 if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
+    @inlinable
     public func read(at index: UInt16) -> UInt32 {
-        var result: UInt32 = 0
-        _ = obx_fbr_read_uint32(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return result
+        return readScalar(at: index) ?? 0
     }
     
     /// - Returns: 0 if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
+    @inlinable
     public func read(at index: UInt16) -> UInt64 {
-        var result: UInt64 = 0
-        _ = obx_fbr_read_uint64(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return result
+        return readScalar(at: index) ?? 0
     }
     
     /// - Returns: 0 if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
+    @inlinable
     public func read(at index: UInt16) -> Int {
-        var result: Int64 = 0
-        _ = obx_fbr_read_int64(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return Int(result)
+        return Int(readScalar(at: index) as Int64? ?? 0)
     }
     
     /// - Returns: 0 if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
+    @inlinable
     public func read(at index: UInt16) -> UInt {
-        var result: UInt64 = 0
-        _ = obx_fbr_read_uint64(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return UInt(result)
+        return UInt(readScalar(at: index) as UInt64? ?? 0)
     }
     
     /// - Returns: 0 if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
+    @inlinable
     public func read(at index: UInt16) -> Float {
-        var result: Float = 0.0
-        _ = obx_fbr_read_float(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return result
+        return readScalar(at: index) ?? 0
     }
     
     /// - Returns: 0 if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
+    @inlinable
     public func read(at index: UInt16) -> Double {
-        var result: Double = 0.0
-        _ = obx_fbr_read_double(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return result
+        return readScalar(at: index) ?? 0
     }
     
     /// - Returns: Jan 1st 1970 if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
     public func read(at index: UInt16) -> Date {
         // Jan 1st 1970 ... People with that birth date are still alive, but Int64.min might confuse some platforms?
-        var result: Int64 = 0
-        _ = obx_fbr_read_int64(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return Date(unixTimestamp: result)
+        return Date(unixTimestamp: readScalar(at: index) ?? 0)
     }
 
     /// - Returns: Jan 1st 1970 if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
     public func readNanos(at index: UInt16) -> Date {
         // Jan 1st 1970 ... People with that birth date are still alive, but Int64.min might confuse some platforms?
-        var result: Int64 = 0
-        _ = obx_fbr_read_int64(unwrapFBR(), index, &result) // If missing, doesn't set "result".
-        return Date(unixTimestampNanos: result)
+        return Date(unixTimestampNanos: readScalar(at: index) ?? 0)
     }
     
     /// - Returns: empty string if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written)
     public func read(at index: UInt16) -> String {
-        guard let result = obx_fbr_read_string(unwrapFBR(), index) else { return "" }
-        return String(utf8String: result) ?? "" // Should only occur if DB contains invalid UTF-8
+        let result: String? = read(at: index)
+        return result ?? ""
     }
     
     /// - Returns: zero-length Data if a value is not present in the buffer
@@ -207,6 +214,42 @@ public struct FlatBufferReader {
         return [Float](bufferPointer)
     }
 
+    /// - Returns: zero-length array if a value is not present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written).
+    public func read(at index: UInt16) -> [Int16] {
+        return read(at: index) ?? []
+    }
+
+    /// - Returns: zero-length array if a value is not present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written).
+    public func read(at index: UInt16) -> [UInt16] {
+        return read(at: index) ?? []
+    }
+
+    /// - Returns: zero-length array if a value is not present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written).
+    public func read(at index: UInt16) -> [Double] {
+        return read(at: index) ?? []
+    }
+
+    /// - Returns: zero-length array if a value is not present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written).
+    public func read(at index: UInt16) -> [Bool] {
+        return read(at: index) ?? []
+    }
+
+    /// - Returns: zero-length array if a value is not present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written).
+    public func read(at index: UInt16) -> [Date] {
+        return read(at: index) ?? []
+    }
+
+    /// - Returns: zero-length array if a value is not present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written).
+    public func readNanos(at index: UInt16) -> [Date] {
+        return readNanos(at: index) ?? []
+    }
+
     /// - Returns: zero-length String array if a value is not present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written).
     public func read(at index: UInt16) -> [String] {
@@ -216,9 +259,7 @@ public struct FlatBufferReader {
     /// - Returns: The ID read, if present, or the invalid ID of 0 if no ID was present.
     public func read<E>(at index: UInt16) -> EntityId<E> where E: EntityInspectable, E: __EntityRelatable,
         E == E.EntityBindingType.EntityType {
-        var result: UInt64 = 0
-        if !obx_fbr_read_uint64(unwrapFBR(), index, &result) { result = 0 }
-        return EntityId<E>(result)
+        return EntityId<E>(readScalar(at: index) ?? 0)
     }
     
     /// - Returns: A to-one relation, ID will == 0 if the relation hasn't been connected yet.
@@ -231,129 +272,116 @@ public struct FlatBufferReader {
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
+    @inlinable
     public func read(at index: UInt16) -> Bool? {
-        var result: Bool = false
-        if !obx_fbr_read_bool(unwrapFBR(), index, &result) { return nil }
-        return result
+        return (readScalar(at: index) as UInt8?).map { $0 != 0 }
     }
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
+    @inlinable
     public func read(at index: UInt16) -> Int8? {
-        var result: Int8 = 0
-        if !obx_fbr_read_int8(unwrapFBR(), index, &result) { return nil }
-        return result
+        return readScalar(at: index)
     }
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
+    @inlinable
     public func read(at index: UInt16) -> Int16? {
-        var result: Int16 = 0
-        if !obx_fbr_read_int16(unwrapFBR(), index, &result) { return nil }
-        return result
+        return readScalar(at: index)
     }
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
+    @inlinable
     public func read(at index: UInt16) -> Int32? {
-        var result: Int32 = 0
-        if !obx_fbr_read_int32(unwrapFBR(), index, &result) { return nil }
-        return result
+        return readScalar(at: index)
     }
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
+    @inlinable
     public func read(at index: UInt16) -> Int64? {
-        var result: Int64 = 0
-        if !obx_fbr_read_int64(unwrapFBR(), index, &result) { return nil }
-        return result
+        return readScalar(at: index)
     }
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
+    @inlinable
     public func read(at index: UInt16) -> UInt8? {
-        var result: UInt8 = 0
-        if !obx_fbr_read_uint8(unwrapFBR(), index, &result) { return nil }
-        return result
+        return readScalar(at: index)
     }
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
+    @inlinable
     public func read(at index: UInt16) -> UInt16? {
-        var result: UInt16 = 0
-        if !obx_fbr_read_uint16(unwrapFBR(), index, &result) { return nil }
-        return result
+        return readScalar(at: index)
     }
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
+    @inlinable
     public func read(at index: UInt16) -> UInt32? {
-        var result: UInt32 = 0
-        if !obx_fbr_read_uint32(unwrapFBR(), index, &result) { return nil }
-        return result
+        return readScalar(at: index)
     }
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
+    @inlinable
     public func read(at index: UInt16) -> UInt64? {
-        var result: UInt64 = 0
-        if !obx_fbr_read_uint64(unwrapFBR(), index, &result) { return nil }
-        return result
+        return readScalar(at: index)
     }
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
+    @inlinable
     public func read(at index: UInt16) -> Float? {
-        var result: Float = 0.0
-        if !obx_fbr_read_float(unwrapFBR(), index, &result) { return nil }
-        return result
+        return readScalar(at: index)
     }
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
+    @inlinable
     public func read(at index: UInt16) -> Double? {
-        var result: Double = 0.0
-        if !obx_fbr_read_double(unwrapFBR(), index, &result) { return nil }
-        return result
+        return readScalar(at: index)
     }
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
+    @inlinable
     public func read(at index: UInt16) -> Int? {
-        var result: Int64 = 0
-        if !obx_fbr_read_int64(unwrapFBR(), index, &result) { return nil }
-        return Int(result)
+        return (readScalar(at: index) as Int64?).map { Int($0) }
     }
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
+    @inlinable
     public func read(at index: UInt16) -> UInt? {
-        var result: UInt64 = 0
-        if !obx_fbr_read_uint64(unwrapFBR(), index, &result) { return nil }
-        return UInt(result)
+        return (readScalar(at: index) as UInt64?).map { UInt($0) }
     }
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
     public func read(at index: UInt16) -> Date? {
-        var result: Int64 = 0
-        if !obx_fbr_read_int64(unwrapFBR(), index, &result) { return nil }
-        return Date(unixTimestamp: result)
+        return (readScalar(at: index) as Int64?).map { Date(unixTimestamp: $0) }
     }
     
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
     public func readNanos(at index: UInt16) -> Date? {
-        var result: Int64 = 0
-        if !obx_fbr_read_int64(unwrapFBR(), index, &result) { return nil }
-        return Date(unixTimestampNanos: result)
+        return (readScalar(at: index) as Int64?).map { Date(unixTimestampNanos: $0) }
     }
 
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional)
     public func read(at index: UInt16) -> String? {
-        guard let result = obx_fbr_read_string(unwrapFBR(), index) else { return nil }
-        return String(utf8String: result) ?? "" // Should only occur if DB contains invalid UTF-8
+        var length = 0
+        guard let result = obx_fbr_read_string_n(unwrapFBR(), index, &length) else { return nil }
+        // Uses the stored length instead of scanning; invalid UTF-8 (not written by ObjectBox) is repaired
+        return result.withMemoryRebound(to: UInt8.self, capacity: length) {
+            String(decoding: UnsafeBufferPointer(start: $0, count: length), as: UTF8.self)
+        }
     }
     
     /// - Returns: nil if the value isn't present in the buffer
@@ -375,7 +403,73 @@ public struct FlatBufferReader {
         let bufferPointer = UnsafeBufferPointer(start: unsafePointer, count: result.size)
         return [UInt8](bufferPointer)
     }
-    
+
+    /// Reads a string property that the binding collects via `prepare(string:compressed:)`; decompresses it if it
+    /// was stored compressed. Other properties must be read without `compressed` so their values are never unpacked.
+    /// - Returns: nil if the value isn't present in the buffer
+    /// - Throws: ObjectBoxError.fileCorrupt if the value was stored compressed but cannot be decompressed, e.g. because
+    ///   its checksum does not match; the stored (compressed) bytes are never returned in place of the value.
+    public func read(at index: UInt16, compressed: Bool) throws -> String? {
+        guard compressed else { return read(at: index) }
+        var result: UnsafePointer<CChar>?
+        var length = 0
+        guard try checkCompressedRead(obx_fbr_read_string_compressed(unwrapFBR(), index, &result, &length), at: index),
+            let string = result else { return nil }
+        return string.withMemoryRebound(to: UInt8.self, capacity: length) {
+            String(decoding: UnsafeBufferPointer(start: $0, count: length), as: UTF8.self)
+        }
+    }
+
+    /// Reads a byte vector property collected via `prepare(bytes:compressed:)`; see `read(at:compressed:) -> String?`.
+    /// - Returns: nil if the value isn't present in the buffer
+    public func read(at index: UInt16, compressed: Bool) throws -> Data? {
+        guard compressed else { return read(at: index) }
+        var result = OBX_bytes()
+        guard try checkCompressedRead(obx_fbr_read_bytes_compressed(unwrapFBR(), index, &result), at: index) else {
+            return nil
+        }
+        guard let data = result.data else { return Data() }
+        return Data(bytes: data, count: result.size)
+    }
+
+    /// Reads a byte vector property collected via `prepare(bytes:compressed:)`; see `read(at:compressed:) -> String?`.
+    /// - Returns: nil if the value isn't present in the buffer
+    public func read(at index: UInt16, compressed: Bool) throws -> [UInt8]? {
+        guard compressed else { return read(at: index) }
+        var result = OBX_bytes()
+        guard try checkCompressedRead(obx_fbr_read_bytes_compressed(unwrapFBR(), index, &result), at: index),
+            let data = result.data else { return nil }
+        return [UInt8](UnsafeBufferPointer(start: data.bindMemory(to: UInt8.self, capacity: result.size),
+                                           count: result.size))
+    }
+
+    /// - Returns: empty string if a value is not present in the buffer; see `read(at:compressed:) -> String?`.
+    public func read(at index: UInt16, compressed: Bool) throws -> String {
+        return try read(at: index, compressed: compressed) ?? ""
+    }
+
+    /// - Returns: zero-length Data if a value is not present in the buffer; see `read(at:compressed:) -> Data?`.
+    public func read(at index: UInt16, compressed: Bool) throws -> Data {
+        return try read(at: index, compressed: compressed) ?? Data()
+    }
+
+    /// - Returns: zero-length array if a value is not present in the buffer; see `read(at:compressed:) -> [UInt8]?`.
+    public func read(at index: UInt16, compressed: Bool) throws -> [UInt8] {
+        return try read(at: index, compressed: compressed) ?? []
+    }
+
+    /// - Returns: true if the compressed value was read, false if it isn't present in the buffer.
+    private func checkCompressedRead(_ err: obx_err, at index: UInt16) throws -> Bool {
+        switch err {
+        case OBX_SUCCESS: return true
+        case OBX_NOT_FOUND: return false
+        case OBX_ERROR_FILE_CORRUPT:
+            try throwObxErr(err, message: "Compressed value at offset \(index) cannot be decompressed")
+        default:
+            try throwObxErr(err, message: "Could not decompress the value at offset \(index)")
+        }
+    }
+
     public func read(at index: UInt16) -> [Int32]? {
         var result = OBX_int32_array()
         guard obx_fbr_read_ints(unwrapFBR(), index, &result) else {
@@ -405,26 +499,256 @@ public struct FlatBufferReader {
         return [Float](bufferPointer)
     }
 
+    /// - Returns: nil if the value isn't present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional).
+    public func read(at index: UInt16) -> [Int16]? {
+        var result = OBX_int16_array()
+        guard obx_fbr_read_shorts(unwrapFBR(), index, &result) else {
+            return nil
+        }
+        let bufferPointer = UnsafeBufferPointer(start: result.items, count: result.count)
+        return [Int16](bufferPointer)
+    }
+
+    /// For char vectors (16 bit characters).
+    /// - Returns: nil if the value isn't present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional).
+    public func read(at index: UInt16) -> [UInt16]? {
+        var result = OBX_int16_array()
+        guard obx_fbr_read_shorts(unwrapFBR(), index, &result) else {
+            return nil
+        }
+        guard let items = result.items, result.count > 0 else { return [] }
+        return [UInt16](unsafeUninitializedCapacity: result.count) { buffer, initializedCount in
+            UnsafeMutableRawPointer(buffer.baseAddress!).copyMemory(from: items,
+                                                                    byteCount: result.count * MemoryLayout<UInt16>.size)
+            initializedCount = result.count
+        }
+    }
+
+    /// - Returns: nil if the value isn't present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional).
+    public func read(at index: UInt16) -> [Double]? {
+        var result = OBX_double_array()
+        guard obx_fbr_read_doubles(unwrapFBR(), index, &result) else {
+            return nil
+        }
+        let bufferPointer = UnsafeBufferPointer(start: result.items, count: result.count)
+        return [Double](bufferPointer)
+    }
+
+    /// - Returns: nil if the value isn't present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional).
+    public func read(at index: UInt16) -> [Bool]? {
+        var result = OBX_bytes()
+        guard obx_fbr_read_bytes(unwrapFBR(), index, &result) else { return nil }
+        guard let data = result.data else { return [] }
+        // Not copied as is: other bindings may have stored any non-zero byte as true
+        let bytes = UnsafeBufferPointer(start: data.assumingMemoryBound(to: UInt8.self), count: result.size)
+        return bytes.map { $0 != 0 }
+    }
+
+    /// - Returns: nil if the value isn't present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional).
+    public func read(at index: UInt16) -> [Date]? {
+        let timestamps: [Int64]? = read(at: index)
+        return timestamps?.map { Date(unixTimestamp: $0) }
+    }
+
+    /// - Returns: nil if the value isn't present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional).
+    public func readNanos(at index: UInt16) -> [Date]? {
+        let timestamps: [Int64]? = read(at: index)
+        return timestamps?.map { Date(unixTimestampNanos: $0) }
+    }
+
     /// - Returns: nil if the value isn't present in the buffer
     ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional).
     public func read(at index: UInt16) -> [String]? {
-        guard let result = obx_fbr_read_strings(unwrapFBR(), index) else {
+        let fbr = unwrapFBR()
+        var count = 0
+        guard obx_fbr_read_strings_count(fbr, index, &count) else {
             return nil
         }
-        defer { obx_flat_strings_free(result) }
-        let count = Int(result.pointee.count)
-        if count == 0 { return [] }
-        guard let items = result.pointee.items else { return [] }
-        let bufferPointer = UnsafeBufferPointer(start: items, count: count)
         var strings: [String] = []
         strings.reserveCapacity(count)
-        for i in 0..<count {
-            let cPtr = bufferPointer[i]
-            // Non-null; should be guaranteed by FlatBuffers vectors and our C wrapper; still do a paranoia check:
-            assert(cPtr != UnsafePointer<CChar>(bitPattern: 0))
-            strings.append(String(cString: cPtr))
+        // Gets the positions of all strings with a single call, then decodes each directly from the FlatBuffer.
+        // The spans only live during this call: temporary allocation uses the stack unless there are many strings.
+        withUnsafeTemporaryAllocation(of: OBX_string_span.self, capacity: count) { spans in
+            var base: UnsafePointer<CChar>?
+            guard obx_fbr_read_string_spans(fbr, index, spans.baseAddress, count, &base),
+                let basePtr = base else { return }  // Not expected; the count was read from the same vector
+            let bytesBase = UnsafeRawPointer(basePtr)
+            for span in spans {
+                let bytes = (bytesBase + Int(span.offset)).assumingMemoryBound(to: UInt8.self)
+                strings.append(String(decoding: UnsafeBufferPointer(start: bytes, count: Int(span.length)),
+                                      as: UTF8.self))
+            }
         }
         return strings
     }
 
+    /// Calls the given closure with the floats aligned to the given alignment, e.g. for SIMD code using aligned loads.
+    /// Floats prepared with this alignment (see `FlatBufferBuilder.prepare(values:alignment:)`) are passed without
+    /// copying if the object's bytes are aligned as well; otherwise they are copied to aligned temporary memory.
+    /// - Parameter alignment: a power of two from 1 to 256.
+    /// - Returns: The closure's result, or nil if the value isn't present in the buffer.
+    public func withFloats<R>(at index: UInt16, alignment: Int,
+                              _ body: (UnsafeBufferPointer<Float>) throws -> R) rethrows -> R? {
+        precondition(FlatBufferBuilder.isValid(alignment: alignment), "Alignment must be a power of two up to 256")
+        var result = OBX_float_array()
+        if obx_fbr_read_floats_aligned(unwrapFBR(), index, alignment, &result) {
+            return try body(UnsafeBufferPointer(start: result.items, count: result.count))
+        }
+        guard obx_fbr_read_floats(unwrapFBR(), index, &result) else { return nil }
+        return try withAlignedCopy(of: UnsafeBufferPointer(start: result.items, count: result.count),
+                                   alignment: alignment, body)
+    }
+
+    /// Like `withFloats(at:alignment:_:)`, but for longs.
+    public func withLongs<R>(at index: UInt16, alignment: Int,
+                             _ body: (UnsafeBufferPointer<Int64>) throws -> R) rethrows -> R? {
+        precondition(FlatBufferBuilder.isValid(alignment: alignment), "Alignment must be a power of two up to 256")
+        var result = OBX_int64_array()
+        if obx_fbr_read_longs_aligned(unwrapFBR(), index, alignment, &result) {
+            return try body(UnsafeBufferPointer(start: result.items, count: result.count))
+        }
+        guard obx_fbr_read_longs(unwrapFBR(), index, &result) else { return nil }
+        return try withAlignedCopy(of: UnsafeBufferPointer(start: result.items, count: result.count),
+                                   alignment: alignment, body)
+    }
+
+    private func withAlignedCopy<T, R>(of values: UnsafeBufferPointer<T>, alignment: Int,
+                                       _ body: (UnsafeBufferPointer<T>) throws -> R) rethrows -> R {
+        let byteCount = values.count * MemoryLayout<T>.stride
+        let memory = UnsafeMutableRawPointer.allocate(byteCount: max(byteCount, 1),
+                                                      alignment: max(alignment, MemoryLayout<T>.alignment))
+        defer { memory.deallocate() }
+        if let source = values.baseAddress, byteCount > 0 {
+            memory.copyMemory(from: source, byteCount: byteCount)
+        }
+        let copy = memory.bindMemory(to: T.self, capacity: values.count)
+        return try body(UnsafeBufferPointer(start: copy, count: values.count))
+    }
+
+    /// Reads the ints without copying; the view points into the object's data, see `VectorView` for its lifetime.
+    /// - Returns: nil if the value isn't present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional).
+    public func read(at index: UInt16) -> VectorView<Int32>? {
+        var result = OBX_int32_array()
+        guard obx_fbr_read_ints(unwrapFBR(), index, &result) else { return nil }
+        return VectorView(UnsafeBufferPointer(start: result.items, count: result.count))
+    }
+
+    /// Reads the longs without copying; the view points into the object's data, see `VectorView` for its lifetime.
+    /// - Returns: nil if the value isn't present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional).
+    public func read(at index: UInt16) -> VectorView<Int64>? {
+        var result = OBX_int64_array()
+        guard obx_fbr_read_longs(unwrapFBR(), index, &result) else { return nil }
+        return VectorView(UnsafeBufferPointer(start: result.items, count: result.count))
+    }
+
+    /// Reads the floats without copying; the view points into the object's data, see `VectorView` for its lifetime.
+    /// - Returns: nil if the value isn't present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional).
+    public func read(at index: UInt16) -> VectorView<Float>? {
+        var result = OBX_float_array()
+        guard obx_fbr_read_floats(unwrapFBR(), index, &result) else { return nil }
+        return VectorView(UnsafeBufferPointer(start: result.items, count: result.count))
+    }
+
+    /// Reads a float vector stored with the given encoding, see `FlatBufferBuilder.prepare(values:encoding:)`.
+    /// - Returns: nil if the value isn't present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional).
+    public func read(at index: UInt16, encoding: VectorEncoding) -> [Float]? {
+        let fbr = unwrapFBR()
+        let cEncoding = OBXVectorEncoding(encoding.rawValue)
+        var count = 0
+        guard obx_fbr_read_floats_count(fbr, index, cEncoding, &count) else { return nil }
+        guard count > 0 else { return [] }
+        return [Float](unsafeUninitializedCapacity: count) { buffer, initializedCount in
+            initializedCount = obx_fbr_read_floats_decoded(fbr, index, cEncoding, buffer.baseAddress!, count)
+        }
+    }
+
+    /// - Returns: zero-length array if a value is not present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written).
+    public func read(at index: UInt16, encoding: VectorEncoding) -> [Float] {
+        return read(at: index, encoding: encoding) ?? []
+    }
+
+    /// Lazily reads a flex property; values are only decoded when accessed via the returned reference.
+    /// - Returns: nil if the value isn't present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional).
+    public func readFlex(at index: UInt16) -> FlexReference? {
+        var ref = OBX_flex_ref()
+        guard obx_fbr_read_flex(unwrapFBR(), index, &ref) else { return nil }
+        return FlexReference(ref)
+    }
+
+    /// - Returns: nil if the value isn't present in the buffer
+    ///         (e.g. because it got added to the schema after this entity was written, or it just is an optional).
+    public func read(at index: UInt16) -> FlexValue? {
+        return readFlex(at: index)?.value
+    }
+
+    /// - Returns: `.null` if the value isn't present in the buffer.
+    public func read(at index: UInt16) -> FlexValue {
+        return readFlex(at: index)?.value ?? .null
+    }
+
+    /// Reads all scalar properties described by the layout into the given row struct with a single call.
+    /// Properties not present in the buffer are set to 0.
+    /// - Parameter presence: Optional bitmap with room for `layout.presenceByteCount` bytes; receives one bit per
+    ///   layout property, which is set if the value was present.
+    public func read(row: UnsafeMutableRawPointer, layout: FlatBufferRowLayout,
+                     presence: UnsafeMutablePointer<UInt8>? = nil) {
+        layout.fields.withUnsafeBufferPointer { fields in
+            guard let fieldsStart = fields.baseAddress else { return }
+            obx_fbr_read_row(unwrapFBR(), fieldsStart, fields.count, row, presence)
+        }
+    }
+
+    /// Reads all scalar properties described by the layout into the given row struct with a single call.
+    /// Properties not present in the buffer are set to 0.
+    public func read<Row>(row: inout Row, layout: FlatBufferRowLayout) {
+        withUnsafeMutableBytes(of: &row) { read(row: $0.baseAddress!, layout: layout) }
+    }
+
+    /// Reads all scalar properties described by the layout into the given row struct with a single call.
+    /// - Parameter presence: Set to a bitmap with one bit per layout property, which is set if the value was present;
+    ///   a cleared bit means the property is NULL (and was set to 0 in the row).
+    public func read<Row>(row: inout Row, layout: FlatBufferRowLayout, presence: inout [UInt8]) {
+        if presence.count < layout.presenceByteCount {
+            presence = [UInt8](repeating: 0, count: layout.presenceByteCount)
+        }
+        withUnsafeMutableBytes(of: &row) { rowBytes in
+            presence.withUnsafeMutableBufferPointer { read(row: rowBytes.baseAddress!, layout: layout,
+                                                           presence: $0.baseAddress) }
+        }
+    }
+}
+
+/// Read-only view of a vector property that points directly into the stored object data instead of copying it, e.g.
+/// to compute a dot product or a checksum without allocating; see `Box.visitReaders(writable:_:)`.
+/// Only valid as long as the data is, i.e. within the visitor callback or the transaction the object was read in.
+/// Do not let it escape; use `Array(view)` to get a copy of the values that can be kept around.
+public struct VectorView<Element>: RandomAccessCollection {
+    /// The values in the object data; same lifetime as the view.
+    public let buffer: UnsafeBufferPointer<Element>
+
+    internal init(_ buffer: UnsafeBufferPointer<Element>) {
+        self.buffer = buffer
+    }
+
+    public var startIndex: Int { return 0 }
+    public var endIndex: Int { return buffer.count }
+
+    public subscript(position: Int) -> Element { return buffer[position] }
+
+    /// Lets e.g. `Array(view)` copy all values at once.
+    public func withContiguousStorageIfAvailable<R>(_ body: (UnsafeBufferPointer<Element>) throws -> R) rethrows -> R? {
+        return try body(buffer)
+    }
 }
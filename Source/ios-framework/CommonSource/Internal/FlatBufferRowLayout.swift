@@ -0,0 +1,56 @@
+//
+// Copyright © 2026 ObjectBox Ltd. <https://objectbox.io>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import Foundation
+
+/// Describes the scalar properties of an entity and where their values are located in a packed "row" struct.
+/// Used by generated Swift code to collect or read all scalars of an object with a single call into the native layer,
+/// instead of one `collect(_:at:)` or `read(at:)` call per property.
+/// Note: nothing in the framework itself calls this yet; `Box.put()`, `Box.all()` and `InstanceVisitor` go through the
+/// entity bindings, so they only use row layouts once the code generator emits them.
+public struct FlatBufferRowLayout {
+    internal private(set) var fields = ContiguousArray<OBX_row_field>()
+
+    public init() {}
+
+    /// Number of properties in this layout.
+    public var count: Int {
+        return fields.count
+    }
+
+    /// Number of bytes a presence bitmap for this layout needs, i.e. one bit per property.
+    public var presenceByteCount: Int {
+        return (fields.count + 7) / 8
+    }
+
+    /// Adds a scalar property whose value is located at the given byte offset of the row struct.
+    /// - Parameter propertyOffset: The FlatBuffers offset of the property, like the one passed to `collect(_:at:)`.
+    /// - Parameter type: A scalar type, i.e. one of bool to double, date, relation or dateNano.
+    /// - Parameter rowOffset: The value's offset, e.g. from `MemoryLayout<Row>.offset(of:)`.
+    public mutating func add(propertyOffset: UInt16, type: PropertyType, rowOffset: Int) {
+        assert(type.rawValue >= PropertyType.bool.rawValue && type.rawValue <= PropertyType.dateNano.rawValue
+               && type != .string, "Only scalar properties can be part of a row layout")
+        fields.append(OBX_row_field(propertyOffset: propertyOffset, type: type.rawValue, rowOffset: UInt32(rowOffset)))
+    }
+
+    /// Adds a scalar property whose value is the stored property of the row struct at the given key path.
+    public mutating func add<Row, Value>(_ keyPath: KeyPath<Row, Value>, propertyOffset: UInt16, type: PropertyType) {
+        guard let rowOffset = MemoryLayout<Row>.offset(of: keyPath) else {
+            fatalError("Row layouts require key paths to stored properties of a struct")
+        }
+        add(propertyOffset: propertyOffset, type: type, rowOffset: rowOffset)
+    }
+}
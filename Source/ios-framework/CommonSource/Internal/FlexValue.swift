@@ -0,0 +1,166 @@
+//
+// Copyright © 2026 ObjectBox Ltd. <https://objectbox.io>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import Foundation
+
+/// A value of a flex property (types flex, flexMap and flexVector), which is stored using the FlexBuffers format.
+/// Like JSON, a flex value may be a scalar, a string, a vector of flex values, or a map of flex values by string keys.
+public enum FlexValue: Equatable {
+    case null
+    case bool(Bool)
+    case int(Int64)
+    case uint(UInt64)
+    case double(Double)
+    case string(String)
+    case blob(Data)
+    case vector([FlexValue])
+    case map([String: FlexValue])
+}
+
+/// Lazy reference to a value of a stored flex property; values are only decoded when accessed.
+/// E.g. looking up a single map value via `reference["key"]` does not decode any other value of the map.
+/// Points directly into the data being read, so only use it while reading the object (do not keep it around).
+public struct FlexReference {
+    private let ref: OBX_flex_ref
+
+    internal init(_ ref: OBX_flex_ref) {
+        self.ref = ref
+    }
+
+    private func with<T>(_ body: (UnsafePointer<OBX_flex_ref>) -> T) -> T {
+        return withUnsafePointer(to: ref, body)
+    }
+
+    public var isNull: Bool { return with { obx_flex_type($0) } == OBXFlexType_Null }
+    public var isVector: Bool { return with { obx_flex_type($0) } == OBXFlexType_Vector }
+    public var isMap: Bool { return with { obx_flex_type($0) } == OBXFlexType_Map }
+
+    /// Numeric values are converted; other types give false.
+    public var boolValue: Bool { return with { obx_flex_as_bool($0) } }
+    /// Numeric values are converted; other types give 0.
+    public var intValue: Int64 { return with { obx_flex_as_int($0) } }
+    /// Numeric values are converted; other types give 0.
+    public var uintValue: UInt64 { return with { obx_flex_as_uint($0) } }
+    /// Numeric values are converted; other types give 0.
+    public var doubleValue: Double { return with { obx_flex_as_double($0) } }
+
+    /// The string value, or nil if the value is not a string.
+    public var stringValue: String? {
+        return with { refPtr -> String? in
+            var length = 0
+            guard let cString = obx_flex_as_string(refPtr, &length) else { return nil }
+            return cString.withMemoryRebound(to: UInt8.self, capacity: length) {
+                String(decoding: UnsafeBufferPointer(start: $0, count: length), as: UTF8.self)
+            }
+        }
+    }
+
+    /// The blob value, or nil if the value is not a blob.
+    public var blobValue: Data? {
+        return with { refPtr -> Data? in
+            var bytes = OBX_bytes()
+            guard obx_flex_as_blob(refPtr, &bytes) else { return nil }
+            guard let data = bytes.data else { return Data() }
+            return Data(bytes: data, count: bytes.size)
+        }
+    }
+
+    /// Number of elements of a vector or entries of a map; 0 for other values.
+    public var count: Int { return with { obx_flex_count($0) } }
+
+    /// The element of a vector (or the value of a map entry, ordered by key) at the given index;
+    /// nil if the value is not a vector or map, or if the index is out of bounds.
+    public subscript(index: Int) -> FlexReference? {
+        guard index >= 0 else { return nil }
+        return with { refPtr -> FlexReference? in
+            var element = OBX_flex_ref()
+            guard obx_flex_at(refPtr, index, &element) else { return nil }
+            return FlexReference(element)
+        }
+    }
+
+    /// Looks up the value for the given key using a binary search; nil if the value is not a map or lacks the key.
+    public subscript(key: String) -> FlexReference? {
+        var key = key
+        return key.withUTF8 { utf8 -> FlexReference? in
+            with { refPtr -> FlexReference? in
+                var value = OBX_flex_ref()
+                let found: Bool
+                if let start = utf8.baseAddress {
+                    found = start.withMemoryRebound(to: CChar.self, capacity: utf8.count) {
+                        obx_flex_lookup(refPtr, $0, utf8.count, &value)
+                    }
+                } else {
+                    found = obx_flex_lookup(refPtr, "", 0, &value)
+                }
+                return found ? FlexReference(value) : nil
+            }
+        }
+    }
+
+    /// The keys of a map in their stored (sorted) order; empty for other values.
+    public var keys: [String] {
+        return with { refPtr -> [String] in
+            let count = obx_flex_count(refPtr)
+            var keys: [String] = []
+            keys.reserveCapacity(count)
+            var cKey: UnsafePointer<CChar>?
+            var length = 0
+            for index in 0..<count {
+                guard obx_flex_key_at(refPtr, index, &cKey, &length), let keyPtr = cKey else { break }
+                keys.append(keyPtr.withMemoryRebound(to: UInt8.self, capacity: length) {
+                    String(decoding: UnsafeBufferPointer(start: $0, count: length), as: UTF8.self)
+                })
+            }
+            return keys
+        }
+    }
+
+    /// Decodes the referenced value, including all nested values.
+    public var value: FlexValue {
+        let type = with { obx_flex_type($0) }
+        switch type {
+        case OBXFlexType_Bool:
+            return .bool(boolValue)
+        case OBXFlexType_Int:
+            return .int(intValue)
+        case OBXFlexType_UInt:
+            return .uint(uintValue)
+        case OBXFlexType_Float:
+            return .double(doubleValue)
+        case OBXFlexType_String, OBXFlexType_Key:
+            return .string(stringValue ?? "")
+        case OBXFlexType_Blob:
+            return .blob(blobValue ?? Data())
+        case OBXFlexType_Vector:
+            var elements: [FlexValue] = []
+            elements.reserveCapacity(count)
+            for index in 0..<count {
+                elements.append(self[index]?.value ?? .null)
+            }
+            return .vector(elements)
+        case OBXFlexType_Map:
+            var entries: [String: FlexValue] = [:]
+            entries.reserveCapacity(count)
+            for (index, key) in keys.enumerated() {
+                entries[key] = self[index]?.value ?? .null
+            }
+            return .map(entries)
+        default:
+            return .null
+        }
+    }
+}
@@ -0,0 +1,81 @@
+//
+// Copyright © 2026 ObjectBox Ltd. <https://objectbox.io>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import Foundation
+
+/// IDs for a known number of new objects, reserved as a contiguous range with a single native call (per 10,000
+/// objects, the maximum of obx_box_ids_for_put()) and then handed out in order, instead of getting each new object's
+/// ID from the box's ID sequence with a separate call.
+internal struct ReservedIds {
+    /// Maximum number of IDs reserved by one call of obx_box_ids_for_put().
+    static let maxRangeSize = 10_000
+
+    private let cBox: OpaquePointer /* OBX_box */
+    private var reservedRanges: [Range<Id>] = []  // Kept to hand out the same IDs again, see rewind()
+    private var rangeIndex = 0
+    private var nextId: Id = 0
+    private var remainingInRange = 0
+    private var remainingToReserve: Int
+
+    /// Nothing is reserved until the first call of `next()`.
+    init(cBox: OpaquePointer, count: Int) {
+        self.cBox = cBox
+        remainingToReserve = count
+    }
+
+    /// Counts the new objects (i.e. with an ID of 0) of the given collection to reserve IDs for. An object contained
+    /// several times is counted each time, so some IDs may remain unused.
+    init<E, C: Collection>(cBox: OpaquePointer, for entities: C, binding: E.EntityBindingType)
+        where E: EntityInspectable, C.Element == E, E == E.EntityBindingType.EntityType {
+        self.init(cBox: cBox, count: entities.reduce(0) { binding.entityId(of: $1) == 0 ? $0 + 1 : $0 })
+    }
+
+    /// The next reserved ID; call at most as many times as IDs were requested.
+    mutating func next() throws -> Id {
+        if remainingInRange == 0 {
+            if rangeIndex < reservedRanges.count {
+                nextId = reservedRanges[rangeIndex].lowerBound
+                remainingInRange = reservedRanges[rangeIndex].count
+            } else {
+                precondition(remainingToReserve > 0, "More IDs requested than were reserved")
+                let count = Swift.min(remainingToReserve, ReservedIds.maxRangeSize)
+                try checkLastError(obx_box_ids_for_put(cBox, UInt64(count), &nextId))
+                reservedRanges.append(nextId ..< nextId + Id(count))
+                remainingInRange = count
+                remainingToReserve -= count
+            }
+            rangeIndex += 1
+        }
+        remainingInRange -= 1
+        defer { nextId += 1 }
+        return nextId
+    }
+
+    /// Hands out the IDs reserved so far again, e.g. when the put they were taken for did not write anything and falls
+    /// back to another way of putting the same objects.
+    mutating func rewind() {
+        rangeIndex = 0
+        remainingInRange = 0
+    }
+
+    /// The ID to put the given object with: its own ID, or a reserved one for a new object.
+    /// - Throws: if the object's own ID is invalid, like a put with `Cursor.idForPut()` would.
+    mutating func id<E: EntityInspectable>(for entity: E, binding: E.EntityBindingType) throws -> Id
+        where E == E.EntityBindingType.EntityType {
+        let entityId = binding.entityId(of: entity)
+        return entityId != 0 ? try checkIdForPut(obx_box_id_for_put(cBox, entityId)) : try next()
+    }
+}
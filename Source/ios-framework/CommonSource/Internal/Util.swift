@@ -44,13 +44,8 @@ internal class Util {
             _ strings: [String],
             _ body: (UnsafePointer<UnsafePointer<CChar>?>, Int) -> R
     ) -> R {
-        // Result placeholder
-        var result: R?
         let count = strings.count
 
-        // Array of C-string pointers (the “char*[]”)
-        var cPointers = [UnsafePointer<CChar>?](repeating: nil, count: count)
-
         // For empty arrays, provide a valid pointer (required by some C APIs marked _Nonnull)
         if count == 0 {
             var empty: UnsafePointer<CChar>?
@@ -59,23 +54,22 @@ internal class Util {
             }
         }
 
-        func recurse(_ index: Int) {
-            if index == count {
-                // All strings converted, call body with buffer pointer
-                cPointers.withUnsafeBufferPointer { buffer in
-                    result = body(buffer.baseAddress!, count)
-                }
-                return
-            }
-
-            strings[index].withCString { cStr in
-                cPointers[index] = cStr
-                recurse(index + 1) // nested closure keeps all previous cStr alive
-            }
+        // Copy all strings zero-terminated into one buffer; unlike nesting withCString for each string, this does
+        // not grow the stack with the array size. Like withCString, a string ends at its first zero character.
+        var cStringsBuffer = ContiguousArray<CChar>()
+        var cStringStarts = ContiguousArray<Int>()
+        cStringStarts.reserveCapacity(count)
+        for string in strings {
+            cStringStarts.append(cStringsBuffer.count)
+            cStringsBuffer.append(contentsOf: string.utf8.lazy.map { CChar(bitPattern: $0) })
+            cStringsBuffer.append(0)
         }
 
-        recurse(0)
-        return result!
+        return cStringsBuffer.withUnsafeBufferPointer { buffer in
+            // Array of C-string pointers (the “char*[]”)
+            let cPointers = cStringStarts.map { UnsafePointer<CChar>?(buffer.baseAddress! + $0) }
+            return cPointers.withUnsafeBufferPointer { body($0.baseAddress!, count) }
+        }
     }
 
     /// Like withCString but for String arrays – mutable pointer variant.
@@ -16,6 +16,11 @@
 
 #include "obx_fbb.h"
 #include "assert.h"
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
 #include <vector>
 
 #pragma GCC diagnostic push
@@ -23,19 +28,915 @@
 #include "flatbuffers/flatbuffers.h"
 #pragma GCC diagnostic pop
 
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 #pragma mark Constants
 
 const flatbuffers::uoffset_t COLLECTING_NOT_STARTED = -1;
 
 
+#pragma mark Hashing
+
+// XXH64 (xxHash, 64 bit variant) of the given bytes, e.g. to checksum a compressed payload.
+static uint64_t obx_xxh64(const void* data, size_t size, uint64_t seed = 0) {
+    const uint64_t P1 = 11400714785074694791ULL;
+    const uint64_t P2 = 14029467366897019727ULL;
+    const uint64_t P3 = 1609587929392839161ULL;
+    const uint64_t P4 = 9650029242287828579ULL;
+    const uint64_t P5 = 2870177450012600261ULL;
+    auto rotl = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+    auto read64 = [](const uint8_t* p) { uint64_t v; memcpy(&v, p, sizeof(v)); return flatbuffers::EndianScalar(v); };
+    auto read32 = [](const uint8_t* p) { uint32_t v; memcpy(&v, p, sizeof(v)); return flatbuffers::EndianScalar(v); };
+    auto round = [&](uint64_t acc, uint64_t input) { return rotl(acc + input * P2, 31) * P1; };
+    auto merge = [&](uint64_t acc, uint64_t value) { return (acc ^ round(0, value)) * P1 + P4; };
+
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + size;
+    uint64_t h;
+    if (size >= 32) {
+        uint64_t v1 = seed + P1 + P2;
+        uint64_t v2 = seed + P2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - P1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = round(v1, read64(p));
+            v2 = round(v2, read64(p + 8));
+            v3 = round(v3, read64(p + 16));
+            v4 = round(v4, read64(p + 24));
+        }
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = merge(merge(merge(merge(h, v1), v2), v3), v4);
+    } else {
+        h = seed + P5;
+    }
+    h += size;
+    for (; p + 8 <= end; p += 8) {
+        h = rotl(h ^ round(0, read64(p)), 27) * P1 + P4;
+    }
+    if (p + 4 <= end) {
+        h = rotl(h ^ (read32(p) * P1), 23) * P2 + P3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h = rotl(h ^ (*p * P5), 11) * P1;
+    }
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+}
+
+
+#pragma mark Compression
+
+// Optional compression of large string and byte vector payloads, using the LZ4 block format.
+// Only properties the binding marks as compressed are decompressed when read. Small values of such properties are
+// stored as they are, so a compressed payload starts with a header: the first magic byte never occurs in valid UTF-8
+// and the checksum of the uncompressed data protects byte vectors that happen to start with the magic.
+namespace obxcompress {
+const uint8_t MAGIC[4] = {0xFF, 'O', 'Z', 1};
+const size_t HEADER_SIZE = 12;  // Magic, uncompressed size (uint32), checksum (lower 32 bits of its XXH64)
+const size_t MAX_RATIO = 255;   // An LZ4 block never decompresses to more than this times its size
+
+using flatbuffers::soffset_t;  // Needed by FLATBUFFERS_MAX_BUFFER_SIZE
+
+const int HASH_BITS = 12;
+const size_t MIN_MATCH = 4;
+const size_t LAST_LITERALS = 5;  // The last bytes of a block are always literals...
+const size_t MF_LIMIT = 12;      // ...and the last match must start at least this many bytes before the end.
+const size_t MAX_OFFSET = 65535;
+
+struct Counters {
+    std::atomic<uint64_t> compressedCount{0};
+    std::atomic<uint64_t> skippedCount{0};
+    std::atomic<uint64_t> uncompressedBytes{0};
+    std::atomic<uint64_t> compressedBytes{0};
+    std::atomic<uint64_t> decompressedCount{0};
+    std::atomic<uint64_t> decodeNanos{0};
+};
+
+Counters counters;
+
+inline size_t bound(size_t size) { return size + size / 255 + 16; }
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t hash(uint32_t sequence) { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+inline uint8_t* writeLength(uint8_t* op, size_t length) {
+    for (; length >= 255; length -= 255) *op++ = 255;
+    *op++ = static_cast<uint8_t>(length);
+    return op;
+}
+
+inline uint8_t* writeSequence(uint8_t* op, const uint8_t* literals, size_t literalLength) {
+    *op++ = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4);
+    if (literalLength >= 15) op = writeLength(op, literalLength - 15);
+    memcpy(op, literals, literalLength);
+    return op + literalLength;
+}
+
+// Greedy LZ4 block compression using a single hash table (1 << HASH_BITS entries).
+// @param dst must have room for bound(size) bytes.
+// @return the compressed size.
+size_t compress(const uint8_t* src, size_t size, uint8_t* dst, uint32_t* table) {
+    memset(table, 0, sizeof(uint32_t) << HASH_BITS);
+    const uint8_t* end = src + size;
+    const uint8_t* anchor = src;
+    uint8_t* op = dst;
+    if (size > MF_LIMIT) {
+        const uint8_t* matchLimit = end - LAST_LITERALS;
+        const uint8_t* searchLimit = end - MF_LIMIT;
+        for (const uint8_t* ip = src; ip < searchLimit;) {
+            uint32_t sequence = read32(ip);
+            uint32_t& entry = table[hash(sequence)];
+            const uint8_t* ref = src + entry;
+            entry = static_cast<uint32_t>(ip - src);
+            if (ref >= ip || static_cast<size_t>(ip - ref) > MAX_OFFSET || read32(ref) != sequence) {
+                ip++;
+                continue;
+            }
+            while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            }
+            const uint8_t* matchEnd = ip + MIN_MATCH;
+            for (const uint8_t* r = ref + MIN_MATCH; matchEnd < matchLimit && *matchEnd == *r; ++r) matchEnd++;
+
+            uint8_t* token = op;
+            op = writeSequence(op, anchor, static_cast<size_t>(ip - anchor));
+            size_t offset = static_cast<size_t>(ip - ref);
+            *op++ = static_cast<uint8_t>(offset);
+            *op++ = static_cast<uint8_t>(offset >> 8);
+            size_t matchLength = static_cast<size_t>(matchEnd - ip) - MIN_MATCH;
+            *token |= static_cast<uint8_t>(matchLength >= 15 ? 15 : matchLength);
+            if (matchLength >= 15) op = writeLength(op, matchLength - 15);
+            ip = anchor = matchEnd;
+        }
+    }
+    op = writeSequence(op, anchor, static_cast<size_t>(end - anchor));
+    return static_cast<size_t>(op - dst);
+}
+
+inline bool readLength(const uint8_t*& ip, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (ip >= end) return false;
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+// Decompresses an LZ4 block; checks all bounds, so corrupt input is rejected instead of read or written past ends.
+// @return false if the block is invalid or does not decompress to exactly dstSize bytes.
+bool decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    const uint8_t* ip = src;
+    const uint8_t* end = src + srcSize;
+    uint8_t* op = dst;
+    uint8_t* outEnd = dst + dstSize;
+    while (ip < end) {
+        uint8_t token = *ip++;
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(ip, end, literalLength)) return false;
+        if (literalLength > static_cast<size_t>(end - ip) || literalLength > static_cast<size_t>(outEnd - op)) {
+            return false;
+        }
+        memcpy(op, ip, literalLength);
+        op += literalLength;
+        ip += literalLength;
+        if (ip == end) break;  // The last sequence has literals only
+
+        if (end - ip < 2) return false;
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) return false;
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(ip, end, matchLength)) return false;
+        matchLength += MIN_MATCH;
+        if (matchLength > static_cast<size_t>(outEnd - op)) return false;
+        const uint8_t* match = op - offset;
+        if (offset >= matchLength) {
+            memcpy(op, match, matchLength);
+        } else {
+            for (size_t i = 0; i < matchLength; ++i) op[i] = match[i];  // Overlapping: repeats the last bytes
+        }
+        op += matchLength;
+    }
+    return op == outEnd;
+}
+
+inline bool isCompressed(const uint8_t* data, size_t size) {
+    return size >= HEADER_SIZE && memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+// A decompression buffer larger than this is released before the next (smaller) decompression on its thread.
+const size_t KEPT_BUFFER_SIZE = 1024 * 1024;
+
+// If the given payload is compressed, decompresses it into a buffer of the calling thread, which is reused by the next
+// decompression on this thread. The decompressed data is zero-terminated (not part of outSize), e.g. for strings.
+// @return OBX_SUCCESS if decompressed, OBX_NO_SUCCESS if the payload is not compressed (i.e. it is stored as it is),
+//         OBX_ERROR_FILE_CORRUPT if it has a compression header but is invalid, or OBX_ERROR_STD_BAD_ALLOC.
+obx_err decompressPayload(const uint8_t* data, size_t size, const uint8_t** outData, size_t* outSize) {
+    if (!isCompressed(data, size)) return OBX_NO_SUCCESS;
+    auto start = std::chrono::steady_clock::now();
+    size_t uncompressedSize = flatbuffers::ReadScalar<uint32_t>(data + 4);
+    uint32_t checksum = flatbuffers::ReadScalar<uint32_t>(data + 8);
+    // Reject sizes no valid block decompresses to before allocating for them, e.g. for a corrupt header
+    if (uncompressedSize > FLATBUFFERS_MAX_BUFFER_SIZE || uncompressedSize > (size - HEADER_SIZE) * MAX_RATIO) {
+        return OBX_ERROR_FILE_CORRUPT;
+    }
+
+    static thread_local std::vector<uint8_t> buffer;
+    try {
+        if (buffer.capacity() > KEPT_BUFFER_SIZE && uncompressedSize + 1 <= KEPT_BUFFER_SIZE) {
+            std::vector<uint8_t>().swap(buffer);  // Do not keep memory of a rare large value for all following reads
+        }
+        if (buffer.size() < uncompressedSize + 1) buffer.resize(uncompressedSize + 1);
+    } catch (std::bad_alloc&) {
+        return OBX_ERROR_STD_BAD_ALLOC;
+    }
+    if (!decompress(data + HEADER_SIZE, size - HEADER_SIZE, buffer.data(), uncompressedSize) ||
+        static_cast<uint32_t>(obx_xxh64(buffer.data(), uncompressedSize)) != checksum) {
+        return OBX_ERROR_FILE_CORRUPT;
+    }
+    buffer[uncompressedSize] = 0;
+    *outData = buffer.data();
+    *outSize = uncompressedSize;
+
+    counters.decompressedCount.fetch_add(1, std::memory_order_relaxed);
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    counters.decodeNanos.fetch_add(static_cast<uint64_t>(nanos.count()), std::memory_order_relaxed);
+    return OBX_SUCCESS;
+}
+}
+
+
+#pragma mark Arena Allocator
+
+// FlatBuffers allocator backed by a per-builder arena: blocks are rounded up to power-of-two size classes and released
+// blocks are kept in a free list per size class instead of being handed back to the heap. Together with the buffer
+// that vector_downward keeps across Clear(), a reused builder reaches a steady state without any heap allocations.
+// Not thread-safe; like the builder it belongs to, it is only used by one thread at a time.
+class OBXArenaAllocator : public flatbuffers::Allocator {
+public:
+    OBXArenaAllocator() = default;
+    OBXArenaAllocator(const OBXArenaAllocator&) = delete;
+    OBXArenaAllocator& operator=(const OBXArenaAllocator&) = delete;
+
+    ~OBXArenaAllocator() override {
+        for (FreeBlock*& head : freeLists_) {
+            while (head) {
+                FreeBlock* next = head->next;
+                delete[] reinterpret_cast<uint8_t*>(head);
+                head = next;
+            }
+        }
+    }
+
+    uint8_t* allocate(size_t size) override {
+        size_t sizeClass = sizeClassFor(size);
+        uint8_t* block;
+        if (FreeBlock* cached = freeLists_[sizeClass]) {
+            freeLists_[sizeClass] = cached->next;
+            block = reinterpret_cast<uint8_t*>(cached);
+        } else {
+            block = new uint8_t[sizeForClass(sizeClass)];  // May throw std::bad_alloc like the default allocator
+            heapAllocations_++;
+            arenaBytes_ += sizeForClass(sizeClass);
+        }
+        inUseBytes_ += sizeForClass(sizeClass);
+        return block;
+    }
+
+    void deallocate(uint8_t* p, size_t size) override {
+        size_t sizeClass = sizeClassFor(size);
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(p);
+        block->next = freeLists_[sizeClass];
+        freeLists_[sizeClass] = block;
+        inUseBytes_ -= sizeForClass(sizeClass);
+    }
+
+    uint8_t* reallocate_downward(uint8_t* old_p, size_t old_size, size_t new_size, size_t in_use_back,
+                                 size_t in_use_front) override {
+        growEvents_++;
+        if (sizeClassFor(old_size) == sizeClassFor(new_size)) {
+            // The block already has room for the new size: only move the in-use back part to the new end.
+            memmove(old_p + new_size - in_use_back, old_p + old_size - in_use_back, in_use_back);
+            return old_p;
+        }
+        return flatbuffers::Allocator::reallocate_downward(old_p, old_size, new_size, in_use_back, in_use_front);
+    }
+
+    uint64_t heapAllocations() const { return heapAllocations_; }
+    uint64_t growEvents() const { return growEvents_; }
+    size_t arenaBytes() const { return arenaBytes_; }
+    size_t inUseBytes() const { return inUseBytes_; }
+
+private:
+    // Free blocks are linked through their own memory; the smallest size class is large enough to hold the link.
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static const size_t MIN_SIZE_CLASS_SHIFT = 10;  // 1 KB, i.e. the initial FlatBufferBuilder size.
+    static const size_t SIZE_CLASS_COUNT = 22;      // Up to 2 GB, the maximum FlatBuffers size.
+
+    static size_t sizeClassFor(size_t size) {
+        size_t sizeClass = 0;
+        while (sizeForClass(sizeClass) < size) sizeClass++;
+        assert(sizeClass < SIZE_CLASS_COUNT);
+        return sizeClass;
+    }
+
+    static size_t sizeForClass(size_t sizeClass) { return size_t(1) << (sizeClass + MIN_SIZE_CLASS_SHIFT); }
+
+    FreeBlock* freeLists_[SIZE_CLASS_COUNT] = {};
+    uint64_t heapAllocations_ = 0;
+    uint64_t growEvents_ = 0;
+    size_t arenaBytes_ = 0;
+    size_t inUseBytes_ = 0;
+};
+
+
+#pragma mark VTable Cache
+
+// Which fields of the table being built were added: one bit per field index (see flatbuffers::FieldIndexToOffset()).
+// Tables with fields beyond the bitmap's range are not cached.
+struct OBXFieldPresence {
+    static const size_t WORD_COUNT = 4;  // 256 fields
+
+    uint64_t words[WORD_COUNT] = {};
+    bool overflow = false;
+
+    void clear() {
+        for (uint64_t& word : words) word = 0;
+        overflow = false;
+    }
+
+    void set(flatbuffers::voffset_t field) {
+        size_t index = (field - flatbuffers::FieldIndexToOffset(0)) / sizeof(flatbuffers::voffset_t);
+        if (field < flatbuffers::FieldIndexToOffset(0) || index >= WORD_COUNT * 64) {
+            overflow = true;
+        } else {
+            words[index / 64] |= uint64_t(1) << (index % 64);
+        }
+    }
+
+    bool isSet(flatbuffers::voffset_t field) const {
+        size_t index = (field - flatbuffers::FieldIndexToOffset(0)) / sizeof(flatbuffers::voffset_t);
+        return field >= flatbuffers::FieldIndexToOffset(0) && index < WORD_COUNT * 64 &&
+               (words[index / 64] & (uint64_t(1) << (index % 64)));
+    }
+
+    bool operator==(const OBXFieldPresence& other) const {
+        return memcmp(words, other.words, sizeof(words)) == 0;
+    }
+};
+
+// Keeps the vtables of recently finished tables across builder clears. FlatBuffers only deduplicates vtables within
+// one buffer, but a thread's builder typically serializes many objects of the same entity one after another.
+// An entry is keyed by the entity and the presence bitmap of the collected fields: the binding of an entity collects
+// its properties in a fixed order with fixed types, so these determine the field positions (and thus the vtable) up
+// to the padding of the table's start, which is part of the key. Table and vtable sizes are compared as a safeguard.
+// Finding a vtable does not depend on the number of fields; a hit pushes the cached bytes in one go.
+class OBXVTableCache {
+public:
+    static const size_t ENTRY_COUNT = 16;  // A few entity types in use concurrently by one thread, two paddings each.
+
+    struct Key {
+        obx_schema_id schemaId = 0;
+        flatbuffers::uoffset_t startPadding = 0;  // Table start modulo the largest scalar alignment
+        flatbuffers::voffset_t vtableSize = 0;
+        flatbuffers::voffset_t tableSize = 0;
+        OBXFieldPresence presence;
+
+        bool operator==(const Key& other) const {
+            return schemaId == other.schemaId && startPadding == other.startPadding &&
+                   vtableSize == other.vtableSize && tableSize == other.tableSize && presence == other.presence;
+        }
+    };
+
+    struct Entry {
+        Key key;
+        std::vector<uint8_t> vtable;
+    };
+
+    // Returns the vtable for the given key or nullptr if it's not cached.
+    const Entry* find(const Key& key) {
+        if (entries_[last_].key == key) {  // Typically the same entity and shape as the previous object
+            hits_++;
+            return &entries_[last_];
+        }
+        for (size_t i = 0; i < ENTRY_COUNT; i++) {
+            if (entries_[i].key == key) {
+                hits_++;
+                last_ = i;
+                return &entries_[i];
+            }
+        }
+        misses_++;
+        return nullptr;
+    }
+
+    // Remembers the given vtable, replacing the oldest entry; assigning keeps the entry's vector capacity.
+    void add(const Key& key, const uint8_t* vtable, size_t size) {
+        Entry& entry = entries_[next_];
+        last_ = next_;
+        next_ = (next_ + 1) % ENTRY_COUNT;
+        entry.key = key;
+        entry.vtable.assign(vtable, vtable + size);
+    }
+
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+
+private:
+    Entry entries_[ENTRY_COUNT];
+    size_t next_ = 0;
+    size_t last_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+// FlatBufferBuilder that tracks the presence of fields and looks up the vtable of a finished table in a
+// OBXVTableCache first. Hides the base class' methods adding fields, so all fields added via this type are tracked.
+class OBXFlatBufferBuilder : public flatbuffers::FlatBufferBuilder {
+public:
+    OBXFlatBufferBuilder(size_t initialSize, flatbuffers::Allocator* allocator)
+            : flatbuffers::FlatBufferBuilder(initialSize, allocator) {}
+
+    // Makes sure the given number of bytes fit without reallocating, e.g. before collecting a large object.
+    void Reserve(size_t size) { buf_.ensure_space(size); }
+
+    size_t Capacity() const { return buf_.capacity(); }
+
+    flatbuffers::uoffset_t StartTable() {
+        presence_.clear();
+        return flatbuffers::FlatBufferBuilder::StartTable();
+    }
+
+    template<typename T> void AddElement(flatbuffers::voffset_t field, T e, T def) {
+        if (e == def && !force_defaults_) return;
+        presence_.set(field);
+        flatbuffers::FlatBufferBuilder::AddElement(field, e, def);
+    }
+
+    template<typename T> void AddOffset(flatbuffers::voffset_t field, flatbuffers::Offset<T> off) {
+        if (off.IsNull()) return;
+        presence_.set(field);
+        flatbuffers::FlatBufferBuilder::AddOffset(field, off);
+    }
+
+    // Like EndTable(), but uses and fills the given cache for tables of the given entity (0 if unknown: not cached).
+    flatbuffers::uoffset_t EndTableCached(flatbuffers::uoffset_t start, obx_schema_id schemaId,
+                                          OBXVTableCache& cache) {
+        FLATBUFFERS_ASSERT(nested);
+        // Only the common case of a buffer without other vtables is cached, so no in-buffer dedup has to be done
+        const size_t fieldLocsSize = num_field_loc * sizeof(FieldLoc);
+        if (schemaId == 0 || presence_.overflow || buf_.scratch_data() != buf_.scratch_end() - fieldLocsSize) {
+            return EndTable(start);
+        }
+
+        // Same as EndTable(): write the offset to the vtable once it's known
+        auto vtableoffsetloc = PushElement<flatbuffers::soffset_t>(0);
+        max_voffset_ = (std::max)(static_cast<flatbuffers::voffset_t>(max_voffset_ + sizeof(flatbuffers::voffset_t)),
+                                  flatbuffers::FieldIndexToOffset(0));
+        auto tableObjectSize = vtableoffsetloc - start;
+        FLATBUFFERS_ASSERT(tableObjectSize < 0x10000);
+
+        key_.schemaId = schemaId;
+        key_.startPadding = start % sizeof(uint64_t);
+        key_.vtableSize = max_voffset_;
+        key_.tableSize = static_cast<flatbuffers::voffset_t>(tableObjectSize);
+        key_.presence = presence_;
+
+        if (const OBXVTableCache::Entry* entry = cache.find(key_)) {
+            assert(MatchesFieldLocs(entry->vtable.data(), vtableoffsetloc));  // Fields collected in a fixed order?
+            ClearOffsets();
+            buf_.push(entry->vtable.data(), entry->vtable.size());
+        } else {
+            buf_.fill_big(max_voffset_);
+            flatbuffers::WriteScalar<flatbuffers::voffset_t>(buf_.data(), max_voffset_);
+            flatbuffers::WriteScalar<flatbuffers::voffset_t>(buf_.data() + sizeof(flatbuffers::voffset_t),
+                                                             key_.tableSize);
+            for (auto it = buf_.scratch_end() - fieldLocsSize; it < buf_.scratch_end(); it += sizeof(FieldLoc)) {
+                auto fieldLocation = reinterpret_cast<FieldLoc*>(it);
+                auto pos = static_cast<flatbuffers::voffset_t>(vtableoffsetloc - fieldLocation->off);
+                // If this asserts, it means you've set a field twice.
+                FLATBUFFERS_ASSERT(!flatbuffers::ReadScalar<flatbuffers::voffset_t>(buf_.data() + fieldLocation->id));
+                flatbuffers::WriteScalar<flatbuffers::voffset_t>(buf_.data() + fieldLocation->id, pos);
+            }
+            ClearOffsets();
+            cache.add(key_, buf_.data(), key_.vtableSize);
+        }
+
+        // As EndTable(), remember the vtable so later tables in this buffer can dedup against it
+        auto vtableUse = GetSize();
+        buf_.scratch_push_small(vtableUse);
+        flatbuffers::WriteScalar(buf_.data_at(vtableoffsetloc), static_cast<flatbuffers::soffset_t>(vtableUse) -
+                                                                 static_cast<flatbuffers::soffset_t>(vtableoffsetloc));
+        nested = false;
+        return vtableoffsetloc;
+    }
+
+    // Whether the given field was already added to the table being built.
+    bool HasField(flatbuffers::voffset_t field) {
+        if (!presence_.overflow) return presence_.isSet(field);
+        for (auto it = buf_.scratch_end() - num_field_loc * sizeof(FieldLoc); it < buf_.scratch_end();
+             it += sizeof(FieldLoc)) {
+            if (reinterpret_cast<FieldLoc*>(it)->id == field) return true;
+        }
+        return false;
+    }
+
+private:
+    // Whether the given cached vtable has the positions of the fields added to the table being built (debug check).
+    bool MatchesFieldLocs(const uint8_t* vtable, flatbuffers::uoffset_t vtableoffsetloc) {
+        for (auto it = buf_.scratch_end() - num_field_loc * sizeof(FieldLoc); it < buf_.scratch_end();
+             it += sizeof(FieldLoc)) {
+            auto fieldLocation = reinterpret_cast<FieldLoc*>(it);
+            auto pos = static_cast<flatbuffers::voffset_t>(vtableoffsetloc - fieldLocation->off);
+            if (flatbuffers::ReadScalar<flatbuffers::voffset_t>(vtable + fieldLocation->id) != pos) return false;
+        }
+        return true;
+    }
+
+    OBXFieldPresence presence_;
+    OBXVTableCache::Key key_;
+};
+
+
+#pragma mark FlexBuffers Builder
+
+// std::allocator-compatible adapter, so standard containers of a builder can take their memory from its arena.
+template<typename T>
+struct OBXArenaStdAllocator {
+    typedef T value_type;
+
+    OBXArenaAllocator* arena;
+
+    explicit OBXArenaStdAllocator(OBXArenaAllocator* arena) : arena(arena) {}
+    template<typename U> OBXArenaStdAllocator(const OBXArenaStdAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return reinterpret_cast<T*>(arena->allocate(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) { arena->deallocate(reinterpret_cast<uint8_t*>(p), n * sizeof(T)); }
+
+    template<typename U> bool operator==(const OBXArenaStdAllocator<U>& other) const { return arena == other.arena; }
+    template<typename U> bool operator!=(const OBXArenaStdAllocator<U>& other) const { return arena != other.arena; }
+};
+
+// FlexBuffers types and bit widths as defined by the FlexBuffers format (see flexbuffers.h of the FlatBuffers project,
+// which is not part of the FlatBuffers version we embed). Only the types written or read by the bridge are listed.
+namespace obxflex {
+enum Type : uint8_t {
+    TYPE_NULL = 0, TYPE_INT = 1, TYPE_UINT = 2, TYPE_FLOAT = 3, TYPE_KEY = 4, TYPE_STRING = 5,
+    TYPE_INDIRECT_INT = 6, TYPE_INDIRECT_UINT = 7, TYPE_INDIRECT_FLOAT = 8, TYPE_MAP = 9, TYPE_VECTOR = 10,
+    TYPE_VECTOR_INT = 11, TYPE_VECTOR_UINT = 12, TYPE_VECTOR_FLOAT = 13, TYPE_VECTOR_KEY = 14,
+    TYPE_VECTOR_STRING_DEPRECATED = 15, TYPE_VECTOR_INT2 = 16, TYPE_VECTOR_FLOAT4 = 24, TYPE_BLOB = 25,
+    TYPE_BOOL = 26, TYPE_VECTOR_BOOL = 36
+};
+
+enum BitWidth : uint8_t { WIDTH_8 = 0, WIDTH_16 = 1, WIDTH_32 = 2, WIDTH_64 = 3 };
+
+inline bool isInline(uint8_t type) { return type <= TYPE_FLOAT || type == TYPE_BOOL; }
+
+inline uint8_t packedType(BitWidth width, uint8_t type) { return static_cast<uint8_t>(width | (type << 2)); }
+
+inline BitWidth widthU(uint64_t u) {
+    if (!(u & ~uint64_t(0xFF))) return WIDTH_8;
+    if (!(u & ~uint64_t(0xFFFF))) return WIDTH_16;
+    if (!(u & ~uint64_t(0xFFFFFFFF))) return WIDTH_32;
+    return WIDTH_64;
+}
+
+inline BitWidth widthI(int64_t i) {
+    uint64_t u = static_cast<uint64_t>(i) << 1;
+    return widthU(i >= 0 ? u : ~u);
+}
+
+inline BitWidth widthF(double f) {
+    return static_cast<double>(static_cast<float>(f)) == f ? WIDTH_32 : WIDTH_64;
+}
+}
+
+// Builds a FlexBuffer like flexbuffers::Builder: values are written front to back, containers refer back to their
+// elements using offsets, and each container uses the smallest byte width fitting all its elements.
+// The buffers are reused for the next FlexBuffer and take their memory from the owning builder's arena.
+class OBXFlexBuilder {
+public:
+    explicit OBXFlexBuilder(OBXArenaAllocator* arena)
+            : buf_(OBXArenaStdAllocator<uint8_t>(arena)), stack_(OBXArenaStdAllocator<Value>(arena)),
+              containerStarts_(OBXArenaStdAllocator<size_t>(arena)) {}
+
+    void clear() {
+        buf_.clear();
+        stack_.clear();
+        containerStarts_.clear();
+    }
+
+    // Bytes reserved by the buffers, which are kept across clear() for the next FlexBuffer.
+    size_t capacityBytes() const {
+        return buf_.capacity() + stack_.capacity() * sizeof(Value) + containerStarts_.capacity() * sizeof(size_t);
+    }
+
+    void addNull() { stack_.push_back(Value::scalar(obxflex::TYPE_NULL, obxflex::WIDTH_8)); }
+
+    void addBool(bool b) {
+        Value value = Value::scalar(obxflex::TYPE_BOOL, obxflex::WIDTH_8);
+        value.u = b ? 1 : 0;
+        stack_.push_back(value);
+    }
+
+    void addInt(int64_t i) {
+        Value value = Value::scalar(obxflex::TYPE_INT, obxflex::widthI(i));
+        value.i = i;
+        stack_.push_back(value);
+    }
+
+    void addUInt(uint64_t u) {
+        Value value = Value::scalar(obxflex::TYPE_UINT, obxflex::widthU(u));
+        value.u = u;
+        stack_.push_back(value);
+    }
+
+    void addDouble(double f) {
+        Value value = Value::scalar(obxflex::TYPE_FLOAT, obxflex::widthF(f));
+        value.f = f;
+        stack_.push_back(value);
+    }
+
+    void addString(const char* str, size_t length) { addSized(obxflex::TYPE_STRING, str, length, 1); }
+
+    void addBlob(const void* data, size_t length) { addSized(obxflex::TYPE_BLOB, data, length, 0); }
+
+    void addKey(const char* key, size_t length) {
+        size_t keyLocation = buf_.size();
+        buf_.insert(buf_.end(), key, key + length);
+        buf_.push_back(0);
+        stack_.push_back(Value::offset(obxflex::TYPE_KEY, keyLocation, obxflex::WIDTH_8));
+    }
+
+    void startContainer() { containerStarts_.push_back(stack_.size()); }
+
+    void endVector() {
+        size_t start = popContainerStart();
+        Value vector = createVector(start, stack_.size() - start, 1, nullptr);
+        stack_.resize(start);
+        stack_.push_back(vector);
+    }
+
+    // Maps are collected as alternating keys and values; FlexBuffers requires the keys to be sorted.
+    void endMap() {
+        size_t start = popContainerStart();
+        size_t length = stack_.size() - start;
+        assert(length % 2 == 0 && "A map needs a value for each key");
+        const uint8_t* buf = buf_.data();
+        Value* pairs = stack_.data() + start;
+        if (length > 2) {
+            // Sort pairs by key; as Value pairs are contiguous, sort them as a single type of two Values
+            struct Pair { Value key; Value value; };
+            static_assert(sizeof(Pair) == 2 * sizeof(Value), "Pairs must be laid out like two Values");
+            Pair* begin = reinterpret_cast<Pair*>(pairs);
+            std::sort(begin, begin + length / 2, [buf](const Pair& a, const Pair& b) {
+                return strcmp(reinterpret_cast<const char*>(buf + a.key.u),
+                              reinterpret_cast<const char*>(buf + b.key.u)) < 0;
+            });
+        }
+        Value keys = createVector(start, length / 2, 2, nullptr, true);
+        Value map = createVector(start + 1, length / 2, 2, &keys);
+        stack_.resize(start);
+        stack_.push_back(map);
+    }
+
+    // Writes the root value; afterwards, the FlexBuffer is available via data() and size().
+    void finish() {
+        assert(stack_.size() == 1 && containerStarts_.empty() && "A FlexBuffer needs exactly one root value");
+        const Value& root = stack_[0];
+        size_t byteWidth = align(root.elemWidth(buf_.size(), 0));
+        writeAny(root, byteWidth);
+        buf_.push_back(root.storedPackedType(obxflex::WIDTH_8));
+        buf_.push_back(static_cast<uint8_t>(byteWidth));
+    }
+
+    const uint8_t* data() const { return buf_.data(); }
+    size_t size() const { return buf_.size(); }
+
+private:
+    struct Value {
+        union {
+            int64_t i;
+            uint64_t u;  // Also the buffer location for offset types
+            double f;
+        };
+        uint8_t type;
+        obxflex::BitWidth minBitWidth;  // For offset types, the width of the target's elements
+
+        static Value scalar(uint8_t type, obxflex::BitWidth width) {
+            Value value;
+            value.u = 0;
+            value.type = type;
+            value.minBitWidth = width;
+            return value;
+        }
+
+        static Value offset(uint8_t type, size_t location, obxflex::BitWidth width) {
+            Value value = scalar(type, width);
+            value.u = location;
+            return value;
+        }
+
+        // Bit width needed to store this value as element elemIndex of a vector written at bufSize.
+        obxflex::BitWidth elemWidth(size_t bufSize, size_t elemIndex) const {
+            if (obxflex::isInline(type)) return minBitWidth;
+            // An offset's width depends on its location, which depends on the (width based) alignment
+            for (size_t byteWidth = 1; byteWidth <= 8; byteWidth *= 2) {
+                size_t offsetLocation = bufSize + paddingBytes(bufSize, byteWidth) + elemIndex * byteWidth;
+                obxflex::BitWidth width = obxflex::widthU(offsetLocation - u);
+                if (size_t(1) << width == byteWidth) return width;
+            }
+            assert(false && "Offset does not fit into 64 bits");
+            return obxflex::WIDTH_64;
+        }
+
+        uint8_t storedPackedType(obxflex::BitWidth parentWidth) const {
+            obxflex::BitWidth width = obxflex::isInline(type) ? std::max(minBitWidth, parentWidth) : minBitWidth;
+            return obxflex::packedType(width, type);
+        }
+    };
+
+    static size_t paddingBytes(size_t bufSize, size_t scalarSize) { return ((~bufSize) + 1) & (scalarSize - 1); }
+
+    size_t popContainerStart() {
+        assert(!containerStarts_.empty() && "No container was started");
+        size_t start = containerStarts_.back();
+        containerStarts_.pop_back();
+        return start;
+    }
+
+    size_t align(obxflex::BitWidth width) {
+        size_t byteWidth = size_t(1) << width;
+        buf_.insert(buf_.end(), paddingBytes(buf_.size(), byteWidth), 0);
+        return byteWidth;
+    }
+
+    void write(uint64_t value, size_t byteWidth) {
+        for (size_t i = 0; i < byteWidth; ++i) buf_.push_back(static_cast<uint8_t>(value >> (8 * i)));  // LE
+    }
+
+    void writeDouble(double f, size_t byteWidth) {
+        if (byteWidth == 8) {
+            uint64_t bits;
+            memcpy(&bits, &f, sizeof(bits));
+            write(bits, 8);
+        } else {
+            assert(byteWidth == 4);
+            float narrowed = static_cast<float>(f);
+            uint32_t bits;
+            memcpy(&bits, &narrowed, sizeof(bits));
+            write(bits, 4);
+        }
+    }
+
+    void writeAny(const Value& value, size_t byteWidth) {
+        switch (value.type) {
+            case obxflex::TYPE_NULL:
+            case obxflex::TYPE_INT:
+            case obxflex::TYPE_UINT:
+            case obxflex::TYPE_BOOL:
+                write(value.u, byteWidth);
+                break;
+            case obxflex::TYPE_FLOAT:
+                writeDouble(value.f, byteWidth);
+                break;
+            default:
+                write(buf_.size() - value.u, byteWidth);  // Offset back to the target
+                break;
+        }
+    }
+
+    void addSized(uint8_t type, const void* data, size_t length, size_t terminatorSize) {
+        obxflex::BitWidth width = obxflex::widthU(length);
+        size_t byteWidth = align(width);
+        write(length, byteWidth);
+        size_t location = buf_.size();
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        buf_.insert(buf_.end(), bytes, bytes + length);
+        buf_.insert(buf_.end(), terminatorSize, 0);
+        stack_.push_back(Value::offset(type, location, width));
+    }
+
+    // Like flexbuffers::Builder::CreateVector(): writes count stack values starting at start (every step-th one).
+    // Keys (typed) are written without per element types; for a map, keys is the already written key vector.
+    Value createVector(size_t start, size_t count, size_t step, const Value* keys, bool typedKeys = false) {
+        obxflex::BitWidth width = obxflex::widthU(count);
+        size_t prefixElems = 1;
+        if (keys) {
+            width = std::max(width, keys->elemWidth(buf_.size(), 0));
+            prefixElems += 2;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            width = std::max(width, stack_[start + i * step].elemWidth(buf_.size(), i + prefixElems));
+        }
+        size_t byteWidth = align(width);
+        if (keys) {
+            write(buf_.size() - keys->u, byteWidth);
+            write(size_t(1) << keys->minBitWidth, byteWidth);
+        }
+        write(count, byteWidth);
+        size_t location = buf_.size();
+        for (size_t i = 0; i < count; ++i) {
+            writeAny(stack_[start + i * step], byteWidth);
+        }
+        if (!typedKeys) {
+            for (size_t i = 0; i < count; ++i) {
+                buf_.push_back(stack_[start + i * step].storedPackedType(width));
+            }
+        }
+        uint8_t type = keys ? obxflex::TYPE_MAP : (typedKeys ? obxflex::TYPE_VECTOR_KEY : obxflex::TYPE_VECTOR);
+        return Value::offset(type, location, width);
+    }
+
+    std::vector<uint8_t, OBXArenaStdAllocator<uint8_t>> buf_;
+    std::vector<Value, OBXArenaStdAllocator<Value>> stack_;
+    std::vector<size_t, OBXArenaStdAllocator<size_t>> containerStarts_;
+};
+
+
+#pragma mark Size Hints
+
+// Learned object sizes per entity type, shared by all builders: a builder reserves the learned size when it starts
+// collecting an object of that type, so even a new builder does not grow repeatedly while collecting large objects.
+// Updates are not synchronized beyond the atomics; concurrent updates may drop a sample, which is fine for a hint.
+namespace obxsizehint {
+const obx_schema_id MAX_SCHEMA_ID = 1023;  // Entity IDs are assigned sequentially, so a plain table does not need a map
+
+struct Entry {
+    std::atomic<uint32_t> averageSize{0};  // Exponential moving average of finished object sizes
+    std::atomic<uint64_t> objectCount{0};
+    std::atomic<uint64_t> reallocations{0};  // Buffer growths while collecting, i.e. the reserved size was too small
+};
+
+Entry entries[MAX_SCHEMA_ID + 1];
+
+inline Entry* entryFor(obx_schema_id schemaId) {
+    return schemaId > 0 && schemaId <= MAX_SCHEMA_ID ? &entries[schemaId] : nullptr;
+}
+
+// Leaves some headroom for objects larger than the average and for the builder's scratch data (e.g. vtables).
+inline size_t reserveSize(uint32_t averageSize) { return averageSize + averageSize / 4; }
+
+void learn(Entry& entry, size_t size, uint64_t reallocations) {
+    uint32_t sample = static_cast<uint32_t>(std::min<size_t>(size, UINT32_MAX));
+    uint32_t average = entry.averageSize.load(std::memory_order_relaxed);
+    if (average > 0) {
+        int64_t delta = static_cast<int64_t>(sample) - average;
+        sample = static_cast<uint32_t>(average + delta / 8);  // Weight of 1/8 for the new sample
+    }
+    entry.averageSize.store(sample, std::memory_order_relaxed);
+    entry.objectCount.fetch_add(1, std::memory_order_relaxed);
+    if (reallocations > 0) entry.reallocations.fetch_add(reallocations, std::memory_order_relaxed);
+}
+}
+
+
 #pragma mark Data Types
 
 // Internal opaque struct used to keep around our state in a way that C callers (and therefore Swift)
 // can deal with it.
 struct OBX_fbb {
     bool isCollecting = false;
-    flatbuffers::FlatBufferBuilder fbb;
+    OBXArenaAllocator allocator;  // Declared before fbb, which uses it until it is destroyed.
+    OBXFlatBufferBuilder fbb{1024, &allocator};
     flatbuffers::uoffset_t collectedTableStart = COLLECTING_NOT_STARTED;
+    OBXVTableCache vtableCache;  // Survives obx_fbb_clear(), unlike FlatBuffers' own vtable dedup
+    std::vector<flatbuffers::Offset<flatbuffers::String>> stringOffsets;  // Reused when preparing string vectors
+    OBXFlexBuilder flex{&allocator};  // Builds the FlexBuffer of a flex property before it is prepared as bytes
+    std::vector<uint8_t> patchBuffer;  // Scratch copy of a stored object being patched; kept for the next patch
+    std::vector<uint8_t> compressBuffer;  // Compressed payload before it is prepared; kept for the next one
+    uint32_t compressTable[1 << obxcompress::HASH_BITS];
+    obx_schema_id schemaId = 0;  // Entity type of the object being collected, if known (see obx_fbb_start_entity())
+    uint64_t growEventsAtStart = 0;
+
+    // Wrapper object of the client (e.g. the Swift builder) living as long as this builder, see obx_fbb_set_owner()
+    void* owner = nullptr;
+    void (*releaseOwner)(void* owner) = nullptr;
+
+    // Objects added via obx_fbb_batch_add(), stored back to back in one arena; capacities are kept across batches.
+    std::vector<uint8_t> batchData;
+    std::vector<size_t> batchOffsets;
+    std::vector<size_t> batchSizes;
+    std::vector<obx_id> batchIds;
 };
 
 // flatbuffers::Table is a variable-length type with no virtual methods. The entire point of the struct below is to
@@ -63,9 +964,56 @@ extern "C" struct OBX_fbb* _Nonnull obx_fbb_create() {
 }
 
 extern "C" void obx_fbb_free(struct OBX_fbb* _Nonnull self) {
+    if (self->owner && self->releaseOwner) self->releaseOwner(self->owner);
     delete self;
 }
 
+// Per-thread stack of builders: a nested put (e.g. of a relation target while collecting the source object) acquires
+// another builder, so there are a few for the nesting depth. Builders beyond the stack's capacity are freed.
+class OBXBuilderPool {
+public:
+    static const size_t CAPACITY = 4;
+
+    ~OBXBuilderPool() {
+        while (count_ > 0) obx_fbb_free(builders_[--count_]);
+    }
+
+    OBX_fbb* acquire() { return count_ > 0 ? builders_[--count_] : obx_fbb_create(); }
+
+    void release(OBX_fbb* builder) {
+        if (count_ < CAPACITY) {
+            builders_[count_++] = builder;
+        } else {
+            obx_fbb_free(builder);
+        }
+    }
+
+private:
+    OBX_fbb* builders_[CAPACITY];
+    size_t count_ = 0;
+};
+
+static thread_local OBXBuilderPool builderPool;
+
+extern "C" struct OBX_fbb* _Nonnull obx_fbb_acquire() {
+    return builderPool.acquire();
+}
+
+extern "C" void obx_fbb_release(struct OBX_fbb* _Nonnull self) {
+    assert(!self->isCollecting);
+    builderPool.release(self);
+}
+
+extern "C" void obx_fbb_set_owner(struct OBX_fbb* _Nonnull self, void* _Nullable owner,
+                                  void (* _Nullable releaseOwner)(void* _Nonnull owner)) {
+    self->owner = owner;
+    self->releaseOwner = releaseOwner;
+}
+
+extern "C" void* _Nullable obx_fbb_owner(struct OBX_fbb* _Nonnull self) {
+    return self->owner;
+}
+
 extern "C" bool obx_fbb_is_collecting(struct OBX_fbb* _Nonnull self) {
     return self->isCollecting;
 }
@@ -74,9 +1022,17 @@ extern "C" void obx_fbb_set_collecting(struct OBX_fbb* _Nonnull self, bool state
     self->isCollecting = state;
 }
 
-extern "C" void obx_fbb_finish(struct OBX_fbb* _Nonnull self, OBX_bytes *outBytes) {
-    auto root = flatbuffers::Offset<flatbuffers::Table>(self->fbb.EndTable(self->collectedTableStart));
+static inline void obx_fbb_finish_table(struct OBX_fbb* _Nonnull self) {
+    auto root = flatbuffers::Offset<flatbuffers::Table>(
+            self->fbb.EndTableCached(self->collectedTableStart, self->schemaId, self->vtableCache));
     self->fbb.Finish(root);
+    if (obxsizehint::Entry* entry = obxsizehint::entryFor(self->schemaId)) {
+        obxsizehint::learn(*entry, self->fbb.GetSize(), self->allocator.growEvents() - self->growEventsAtStart);
+    }
+}
+
+extern "C" void obx_fbb_finish(struct OBX_fbb* _Nonnull self, OBX_bytes *outBytes) {
+    obx_fbb_finish_table(self);
     outBytes->data = self->fbb.GetBufferPointer();
     outBytes->size = self->fbb.GetSize();
 }
@@ -92,9 +1048,118 @@ extern "C" void obx_fbb_ensure_started(struct OBX_fbb* _Nonnull self) {
 
 extern "C" void obx_fbb_clear(struct OBX_fbb* _Nonnull self) {
     self->collectedTableStart = COLLECTING_NOT_STARTED;
+    self->schemaId = 0;
     self->fbb.Clear();
 }
 
+extern "C" void obx_fbb_start_entity(struct OBX_fbb* _Nonnull self, obx_schema_id entitySchemaId) {
+    self->schemaId = entitySchemaId;
+    if (obxsizehint::Entry* entry = obxsizehint::entryFor(entitySchemaId)) {
+        uint32_t averageSize = entry->averageSize.load(std::memory_order_relaxed);
+        if (averageSize > 0) {
+            try {
+                self->fbb.Reserve(obxsizehint::reserveSize(averageSize));
+            } catch(std::bad_alloc& err) {
+                // Just a hint; collecting will try again to allocate what is actually needed
+            }
+        }
+    }
+    self->growEventsAtStart = self->allocator.growEvents();
+}
+
+extern "C" bool obx_fbb_size_hint(obx_schema_id entitySchemaId, struct OBX_fbb_size_hint* _Nonnull outHint) {
+    obxsizehint::Entry* entry = obxsizehint::entryFor(entitySchemaId);
+    if (!entry) return false;
+    uint32_t averageSize = entry->averageSize.load(std::memory_order_relaxed);
+    outHint->average_size = averageSize;
+    outHint->reserve_size = averageSize > 0 ? obxsizehint::reserveSize(averageSize) : 0;
+    outHint->object_count = entry->objectCount.load(std::memory_order_relaxed);
+    outHint->reallocations = entry->reallocations.load(std::memory_order_relaxed);
+    return true;
+}
+
+extern "C" bool obx_fbb_matches(struct OBX_fbb* _Nonnull self, const void* _Nonnull stored, size_t storedSize) {
+    return self->fbb.GetSize() == storedSize && memcmp(self->fbb.GetBufferPointer(), stored, storedSize) == 0;
+}
+
+#pragma mark - Batches
+
+// Appends the finished object to the batch.
+static void obx_fbb_batch_append(struct OBX_fbb* _Nonnull self, obx_id id) {
+    const uint8_t* data = self->fbb.GetBufferPointer();
+    size_t size = self->fbb.GetSize();
+
+    // Keep each object aligned like the builder's buffer, so it can be read in place
+    size_t offset = (self->batchData.size() + 7) & ~size_t(7);
+    self->batchData.insert(self->batchData.end(), offset - self->batchData.size(), 0);
+    self->batchData.insert(self->batchData.end(), data, data + size);
+
+    self->batchOffsets.push_back(offset);
+    self->batchSizes.push_back(size);
+    self->batchIds.push_back(id);
+    obx_fbb_clear(self);
+}
+
+extern "C" void obx_fbb_batch_add(struct OBX_fbb* _Nonnull self, obx_id id) {
+    obx_fbb_finish_table(self);
+    obx_fbb_batch_append(self, id);
+}
+
+extern "C" bool obx_fbb_batch_add_changed(struct OBX_fbb* _Nonnull self, obx_id id, const void* _Nullable stored,
+                                          size_t storedSize) {
+    obx_fbb_finish_table(self);
+    if (stored && obx_fbb_matches(self, stored, storedSize)) {
+        obx_fbb_clear(self);
+        return false;
+    }
+    obx_fbb_batch_append(self, id);
+    return true;
+}
+
+extern "C" size_t obx_fbb_batch_count(struct OBX_fbb* _Nonnull self) {
+    return self->batchIds.size();
+}
+
+extern "C" obx_err obx_fbb_batch_put(struct OBX_fbb* _Nonnull self, OBX_cursor* _Nonnull cursor, OBXPutMode mode) {
+    const uint8_t* data = self->batchData.data();
+    for (size_t i = 0; i < self->batchIds.size(); ++i) {
+        obx_err err = obx_cursor_put4(cursor, self->batchIds[i], data + self->batchOffsets[i],
+                                      self->batchSizes[i], mode);
+        if (err != OBX_SUCCESS) return err;
+    }
+    return OBX_SUCCESS;
+}
+
+extern "C" void obx_fbb_batch_clear(struct OBX_fbb* _Nonnull self) {
+    self->batchData.clear();
+    self->batchOffsets.clear();
+    self->batchSizes.clear();
+    self->batchIds.clear();
+}
+
+#pragma mark -
+
+extern "C" void obx_fbb_stats(struct OBX_fbb* _Nonnull self, struct OBX_fbb_stats* _Nonnull outStats) {
+    outStats->heap_allocations = self->allocator.heapAllocations();
+    outStats->grow_events = self->allocator.growEvents();
+    outStats->arena_bytes = self->allocator.arenaBytes();
+    outStats->in_use_bytes = self->allocator.inUseBytes();
+    outStats->capacity = self->fbb.Capacity();
+    outStats->flex_capacity = self->flex.capacityBytes();
+    outStats->vtable_cache_hits = self->vtableCache.hits();
+    outStats->vtable_cache_misses = self->vtableCache.misses();
+}
+
+extern "C" void obx_compression_stats(struct OBX_compression_stats* _Nonnull outStats) {
+    const obxcompress::Counters& counters = obxcompress::counters;
+    outStats->compressed_count = counters.compressedCount.load(std::memory_order_relaxed);
+    outStats->skipped_count = counters.skippedCount.load(std::memory_order_relaxed);
+    outStats->uncompressed_bytes = counters.uncompressedBytes.load(std::memory_order_relaxed);
+    outStats->compressed_bytes = counters.compressedBytes.load(std::memory_order_relaxed);
+    outStats->decompressed_count = counters.decompressedCount.load(std::memory_order_relaxed);
+    outStats->decode_nanos = counters.decodeNanos.load(std::memory_order_relaxed);
+}
+
 extern "C" void obx_fbb_collect_bool(struct OBX_fbb* _Nonnull self, bool value, uint16_t propertyOffset) {
     GUARD_IS_COLLECTING;
     obx_ensure_started_fast(self);
@@ -172,6 +1237,68 @@ extern "C" void obx_fbb_collect_double(struct OBX_fbb* _Nonnull self, double val
     self->fbb.AddElement<double>(propertyOffset, value, 0);
 }
 
+// Size in bytes of a scalar OBXPropertyType value; 0 for non-scalar types.
+static inline size_t obx_scalar_size(uint16_t type) {
+    switch (type) {
+        case OBXPropertyType_Bool:
+        case OBXPropertyType_Byte:
+            return 1;
+        case OBXPropertyType_Short:
+        case OBXPropertyType_Char:
+            return 2;
+        case OBXPropertyType_Int:
+        case OBXPropertyType_Float:
+            return 4;
+        case OBXPropertyType_Long:
+        case OBXPropertyType_Double:
+        case OBXPropertyType_Date:
+        case OBXPropertyType_Relation:
+        case OBXPropertyType_DateNano:
+            return 8;
+        default:
+            return 0;
+    }
+}
+
+extern "C" void obx_fbb_collect_row(struct OBX_fbb* _Nonnull self, const struct OBX_row_field* _Nonnull fields,
+                                    size_t count, const void* _Nonnull row, const uint8_t* _Nullable presence) {
+    GUARD_IS_COLLECTING;
+    obx_ensure_started_fast(self);
+
+    // Integers only need their size (FlatBuffers stores the bit pattern), but floating point values are added like
+    // obx_fbb_collect_float/double() do, so e.g. -0.0 is compared to the default as a float, not as its bit pattern
+    const uint8_t* rowBytes = static_cast<const uint8_t*>(row);
+    for (size_t i = 0; i < count; ++i) {
+        if (presence && !(presence[i >> 3] & (1u << (i & 7)))) continue;
+        const OBX_row_field& field = fields[i];
+        const uint8_t* value = rowBytes + field.rowOffset;
+        if (field.type == OBXPropertyType_Float) {
+            self->fbb.AddElement<float>(field.propertyOffset, *reinterpret_cast<const float*>(value), 0);
+            continue;
+        }
+        if (field.type == OBXPropertyType_Double) {
+            self->fbb.AddElement<double>(field.propertyOffset, *reinterpret_cast<const double*>(value), 0);
+            continue;
+        }
+        switch (obx_scalar_size(field.type)) {
+            case 1:
+                self->fbb.AddElement<uint8_t>(field.propertyOffset, *value, 0);
+                break;
+            case 2:
+                self->fbb.AddElement<uint16_t>(field.propertyOffset, *reinterpret_cast<const uint16_t*>(value), 0);
+                break;
+            case 4:
+                self->fbb.AddElement<uint32_t>(field.propertyOffset, *reinterpret_cast<const uint32_t*>(value), 0);
+                break;
+            case 8:
+                self->fbb.AddElement<uint64_t>(field.propertyOffset, *reinterpret_cast<const uint64_t*>(value), 0);
+                break;
+            default:
+                assert(false && "Row layouts may only contain scalar properties");
+        }
+    }
+}
+
 extern "C" void obx_fbb_collect_data_offset(struct OBX_fbb* _Nonnull self, OBXDataOffset dataOffset, uint16_t propertyOffset) {
     GUARD_IS_COLLECTING;
     obx_ensure_started_fast(self);
@@ -197,6 +1324,22 @@ extern "C" OBXDataOffset obx_fbb_prepare_string(struct OBX_fbb* _Nonnull self, c
     return result;
 }
 
+extern "C" OBXDataOffset obx_fbb_prepare_string_n(struct OBX_fbb* _Nonnull self, const char* _Nonnull string,
+                                                  size_t length) {
+    GUARD_IS_COLLECTING;
+    assert(!obx_is_started_fast(self)); // Strings must be collected before scalars.
+
+    OBXDataOffset result = 0;
+    try {
+        flatbuffers::Offset<flatbuffers::String> stringOffset = self->fbb.CreateString(string, length);
+        result = stringOffset.o;
+    } catch(std::bad_alloc& err) {
+        fprintf(stderr, "Unexpected bad_alloc error collecting string.");
+        result = 0;
+    }
+    return result;
+}
+
 extern "C" OBXDataOffset obx_fbb_prepare_bytes(struct OBX_fbb* _Nonnull self, const void* _Nonnull bytes, size_t size) {
     GUARD_IS_COLLECTING;
     assert(!obx_is_started_fast(self)); // Byte vectors must be collected before scalars.
@@ -212,6 +1355,71 @@ extern "C" OBXDataOffset obx_fbb_prepare_bytes(struct OBX_fbb* _Nonnull self, co
     return result;
 }
 
+// Compresses the given payload into the compress buffer (header and LZ4 block).
+// @return false if the payload is stored uncompressed, e.g. because it is small or does not compress well.
+static bool obx_fbb_compress(struct OBX_fbb* _Nonnull self, const void* _Nonnull data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    // Stored as it is, a payload starting like a compressed one would be read as (corrupt) compressed data
+    bool mustCompress = obxcompress::isCompressed(bytes, size) && size <= UINT32_MAX;
+    if (!mustCompress && (size < OBX_FBB_COMPRESSION_MIN_SIZE || size > UINT32_MAX)) return false;
+    self->compressBuffer.resize(obxcompress::HEADER_SIZE + obxcompress::bound(size));
+    uint8_t* out = self->compressBuffer.data();
+    size_t compressedSize = obxcompress::HEADER_SIZE +
+            obxcompress::compress(bytes, size, out + obxcompress::HEADER_SIZE, self->compressTable);
+    if (!mustCompress && compressedSize > size - size / 8) {  // Less than 12.5 % saved: not worth decompressing
+        obxcompress::counters.skippedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    memcpy(out, obxcompress::MAGIC, sizeof(obxcompress::MAGIC));
+    flatbuffers::WriteScalar<uint32_t>(out + 4, static_cast<uint32_t>(size));
+    flatbuffers::WriteScalar<uint32_t>(out + 8, static_cast<uint32_t>(obx_xxh64(bytes, size)));
+    self->compressBuffer.resize(compressedSize);
+
+    obxcompress::counters.compressedCount.fetch_add(1, std::memory_order_relaxed);
+    obxcompress::counters.uncompressedBytes.fetch_add(size, std::memory_order_relaxed);
+    obxcompress::counters.compressedBytes.fetch_add(compressedSize, std::memory_order_relaxed);
+    return true;
+}
+
+extern "C" OBXDataOffset obx_fbb_prepare_bytes_compressed(struct OBX_fbb* _Nonnull self, const void* _Nonnull bytes,
+                                                          size_t size) {
+    GUARD_IS_COLLECTING;
+    assert(!obx_is_started_fast(self)); // Byte vectors must be collected before scalars.
+
+    OBXDataOffset result = 0;
+    try {
+        if (obx_fbb_compress(self, bytes, size)) {
+            result = self->fbb.CreateVector(self->compressBuffer.data(), self->compressBuffer.size()).o;
+        } else {
+            result = self->fbb.CreateVector(static_cast<const uint8_t*>(bytes), size).o;
+        }
+    } catch(std::bad_alloc& err) {
+        fprintf(stderr, "Unexpected bad_alloc error collecting byte vector.");
+        result = 0;
+    }
+    return result;
+}
+
+extern "C" OBXDataOffset obx_fbb_prepare_string_compressed(struct OBX_fbb* _Nonnull self, const char* _Nonnull string,
+                                                           size_t length) {
+    GUARD_IS_COLLECTING;
+    assert(!obx_is_started_fast(self)); // Strings must be collected before scalars.
+
+    OBXDataOffset result = 0;
+    try {
+        if (obx_fbb_compress(self, string, length)) {
+            const char* compressed = reinterpret_cast<const char*>(self->compressBuffer.data());
+            result = self->fbb.CreateString(compressed, self->compressBuffer.size()).o;
+        } else {
+            result = self->fbb.CreateString(string, length).o;
+        }
+    } catch(std::bad_alloc& err) {
+        fprintf(stderr, "Unexpected bad_alloc error collecting string.");
+        result = 0;
+    }
+    return result;
+}
+
 extern "C" OBXDataOffset obx_fbb_prepare_ints(struct OBX_fbb* _Nonnull self, const void* _Nonnull ints, size_t size) {
     GUARD_IS_COLLECTING;
     assert(!obx_is_started_fast(self)); // Must be collected before scalars.
@@ -242,6 +1450,21 @@ extern "C" OBXDataOffset obx_fbb_prepare_longs(struct OBX_fbb* _Nonnull self, co
     return result;
 }
 
+extern "C" OBXDataOffset obx_fbb_prepare_shorts(struct OBX_fbb* _Nonnull self, const void* _Nonnull shorts, size_t size) {
+    GUARD_IS_COLLECTING;
+    assert(!obx_is_started_fast(self)); // Must be collected before scalars.
+
+    OBXDataOffset result = 0;
+    try {
+        flatbuffers::Offset<flatbuffers::Vector<int16_t>> vectorOffset = self->fbb.CreateVector((int16_t *)shorts, size);
+        result = vectorOffset.o;
+    } catch(std::bad_alloc& err) {
+        fprintf(stderr, "Unexpected bad_alloc error collecting int16 vector.");
+        result = 0;
+    }
+    return result;
+}
+
 extern "C" OBXDataOffset obx_fbb_prepare_floats(struct OBX_fbb* _Nonnull self, const void* _Nonnull floats, size_t size) {
     GUARD_IS_COLLECTING;
     assert(!obx_is_started_fast(self)); // Must be collected before scalars.
@@ -257,17 +1480,95 @@ extern "C" OBXDataOffset obx_fbb_prepare_floats(struct OBX_fbb* _Nonnull self, c
     return result;
 }
 
+// Vector alignments supported by the aligned prepare and read functions: powers of two up to 256.
+static inline bool obx_is_valid_alignment(size_t alignment) {
+    return alignment > 0 && alignment <= 256 && (alignment & (alignment - 1)) == 0;
+}
+
+// Creates a vector whose elements start at the given alignment (relative to the start of the finished FlatBuffer).
+// The padding goes in front of the vector's length, as FlatBuffers is built back to front.
+template<typename T>
+static OBXDataOffset obx_fbb_prepare_vector_aligned(struct OBX_fbb* _Nonnull self, const T* _Nonnull values,
+                                                    size_t size, size_t alignment) {
+    GUARD_IS_COLLECTING;
+    assert(!obx_is_started_fast(self)); // Must be collected before scalars.
+    if (!obx_is_valid_alignment(alignment)) {
+        fprintf(stderr, "Invalid vector alignment %zu; must be a power of two up to 256.", alignment);
+        return 0;
+    }
+
+    OBXDataOffset result = 0;
+    try {
+        if (alignment > sizeof(T)) self->fbb.ForceVectorAlignment(size, sizeof(T), alignment);
+        result = self->fbb.CreateVector(values, size).o;
+    } catch(std::bad_alloc& err) {
+        fprintf(stderr, "Unexpected bad_alloc error collecting aligned vector.");
+        result = 0;
+    }
+    return result;
+}
+
+extern "C" OBXDataOffset obx_fbb_prepare_floats_aligned(struct OBX_fbb* _Nonnull self, const void* _Nonnull floats,
+                                                        size_t size, size_t alignment) {
+    return obx_fbb_prepare_vector_aligned(self, static_cast<const float*>(floats), size, alignment);
+}
+
+extern "C" OBXDataOffset obx_fbb_prepare_longs_aligned(struct OBX_fbb* _Nonnull self, const void* _Nonnull longs,
+                                                       size_t size, size_t alignment) {
+    return obx_fbb_prepare_vector_aligned(self, static_cast<const int64_t*>(longs), size, alignment);
+}
+
+extern "C" OBXDataOffset obx_fbb_prepare_doubles(struct OBX_fbb* _Nonnull self, const void* _Nonnull doubles, size_t size) {
+    GUARD_IS_COLLECTING;
+    assert(!obx_is_started_fast(self)); // Must be collected before scalars.
+
+    OBXDataOffset result = 0;
+    try {
+        flatbuffers::Offset<flatbuffers::Vector<double>> vectorOffset = self->fbb.CreateVector((double *)doubles, size);
+        result = vectorOffset.o;
+    } catch(std::bad_alloc& err) {
+        fprintf(stderr, "Unexpected bad_alloc error collecting double vector.");
+        result = 0;
+    }
+    return result;
+}
+
+extern "C" OBXDataOffset obx_fbb_prepare_strings_blob(struct OBX_fbb* _Nonnull self, const char* _Nonnull blob,
+                                                      const size_t* _Nonnull lengths, size_t count) {
+    GUARD_IS_COLLECTING;
+    assert(!obx_is_started_fast(self)); // Must be collected before scalars.
+
+    OBXDataOffset result = 0;
+    try {
+        std::vector<flatbuffers::Offset<flatbuffers::String>>& stringOffsets = self->stringOffsets;
+        stringOffsets.clear();
+        stringOffsets.reserve(count);
+        const char* string = blob;
+        for (size_t i = 0; i < count; ++i) {
+            stringOffsets.push_back(self->fbb.CreateString(string, lengths[i]));
+            string += lengths[i];
+        }
+
+        flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> vectorOffset =
+            self->fbb.CreateVector(stringOffsets);
+        result = vectorOffset.o;
+    } catch(std::bad_alloc& err) {
+        fprintf(stderr, "Unexpected bad_alloc error collecting string vector.");
+        result = 0;
+    }
+    return result;
+}
+
 extern "C" OBXDataOffset obx_fbb_prepare_strings(struct OBX_fbb* _Nonnull self, const char* _Nonnull const * _Nonnull strings, size_t size) {
     GUARD_IS_COLLECTING;
     assert(!obx_is_started_fast(self)); // Must be collected before scalars.
 
     OBXDataOffset result = 0;
     try {
-        // Create a vector to hold string offsets
-        std::vector<flatbuffers::Offset<flatbuffers::String>> stringOffsets;
+        // Create each string and store its offset (in the builder's reused offsets vector)
+        std::vector<flatbuffers::Offset<flatbuffers::String>>& stringOffsets = self->stringOffsets;
+        stringOffsets.clear();
         stringOffsets.reserve(size);
-
-        // Create each string and store its offset
         for (size_t i = 0; i < size; ++i) {
             stringOffsets.push_back(self->fbb.CreateString(strings[i]));
         }
@@ -396,18 +1697,84 @@ extern "C" const char * _Nullable obx_fbr_read_string(const struct OBX_fbr* _Non
     return string->c_str();
 }
 
+extern "C" const char * _Nullable obx_fbr_read_string_n(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                                        size_t* _Nonnull outLength) {
+    const flatbuffers::String *string = self->GetPointer<const flatbuffers::String *>(propertyOffset);
+    if (!string) {
+        return nullptr;
+    }
+    *outLength = string->size();
+    return string->c_str();
+}
+
+extern "C" obx_err obx_fbr_read_string_compressed(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                                  const char* _Nullable * _Nonnull outString,
+                                                  size_t* _Nonnull outLength) {
+    const flatbuffers::String *string = self->GetPointer<const flatbuffers::String *>(propertyOffset);
+    if (!string) {
+        return OBX_NOT_FOUND;
+    }
+    const uint8_t* decompressed;
+    size_t size;
+    obx_err err = obxcompress::decompressPayload(string->Data(), string->size(), &decompressed, &size);
+    if (err == OBX_NO_SUCCESS) {
+        *outString = string->c_str();
+        *outLength = string->size();
+        return OBX_SUCCESS;
+    }
+    if (err == OBX_SUCCESS) {
+        *outString = reinterpret_cast<const char*>(decompressed);
+        *outLength = size;
+    }
+    return err;
+}
+
 extern "C" bool obx_fbr_read_bytes(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, OBX_bytes* outBytes) {
     const flatbuffers::Vector<uint8_t> *vector = self->GetPointer<const flatbuffers::Vector<uint8_t> *>(propertyOffset);
     if (!vector) {
         return false;
     }
-    
+
     outBytes->data = vector->data();
     outBytes->size = vector->size();
     
     return true;
 }
 
+extern "C" obx_err obx_fbr_read_bytes_compressed(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                                 OBX_bytes* _Nonnull outBytes) {
+    const flatbuffers::Vector<uint8_t> *vector = self->GetPointer<const flatbuffers::Vector<uint8_t> *>(propertyOffset);
+    if (!vector) {
+        return OBX_NOT_FOUND;
+    }
+
+    const uint8_t* decompressed;
+    size_t size;
+    obx_err err = obxcompress::decompressPayload(vector->data(), vector->size(), &decompressed, &size);
+    if (err == OBX_NO_SUCCESS) {
+        outBytes->data = vector->data();
+        outBytes->size = vector->size();
+        return OBX_SUCCESS;
+    }
+    if (err == OBX_SUCCESS) {
+        outBytes->data = decompressed;
+        outBytes->size = size;
+    }
+    return err;
+}
+
+extern "C" bool obx_fbr_read_shorts(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, OBX_int16_array* outShorts) {
+    const flatbuffers::Vector<int16_t> *vector = self->GetPointer<const flatbuffers::Vector<int16_t> *>(propertyOffset);
+    if (!vector) {
+        return false;
+    }
+
+    outShorts->items = vector->data();
+    outShorts->count = vector->size();
+
+    return true;
+}
+
 extern "C" bool obx_fbr_read_ints(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, OBX_int32_array* outInts) {
     const flatbuffers::Vector<int32_t> *vector = self->GetPointer<const flatbuffers::Vector<int32_t> *>(propertyOffset);
     if (!vector) {
@@ -432,6 +1799,20 @@ extern "C" bool obx_fbr_read_longs(const struct OBX_fbr* _Nonnull self, uint16_t
     return true;
 }
 
+extern "C" bool obx_fbr_read_longs_aligned(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                           size_t alignment, OBX_int64_array* outLongs) {
+    if (!obx_is_valid_alignment(alignment)) return false;
+    const flatbuffers::Vector<int64_t> *vector = self->GetPointer<const flatbuffers::Vector<int64_t> *>(propertyOffset);
+    if (!vector || reinterpret_cast<uintptr_t>(vector->data()) % alignment != 0) {
+        return false;
+    }
+
+    outLongs->items = vector->data();
+    outLongs->count = vector->size();
+
+    return true;
+}
+
 extern "C" bool obx_fbr_read_floats(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, OBX_float_array* outFloats) {
     const flatbuffers::Vector<float> *vector = self->GetPointer<const flatbuffers::Vector<float> *>(propertyOffset);
     if (!vector) {
@@ -444,6 +1825,56 @@ extern "C" bool obx_fbr_read_floats(const struct OBX_fbr* _Nonnull self, uint16_
     return true;
 }
 
+extern "C" bool obx_fbr_read_floats_aligned(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                            size_t alignment, OBX_float_array* outFloats) {
+    if (!obx_is_valid_alignment(alignment)) return false;
+    const flatbuffers::Vector<float> *vector = self->GetPointer<const flatbuffers::Vector<float> *>(propertyOffset);
+    if (!vector || reinterpret_cast<uintptr_t>(vector->data()) % alignment != 0) {
+        return false;
+    }
+
+    outFloats->items = vector->data();
+    outFloats->count = vector->size();
+
+    return true;
+}
+
+extern "C" bool obx_fbr_read_doubles(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, OBX_double_array* outDoubles) {
+    const flatbuffers::Vector<double> *vector = self->GetPointer<const flatbuffers::Vector<double> *>(propertyOffset);
+    if (!vector) {
+        return false;
+    }
+
+    outDoubles->items = vector->data();
+    outDoubles->count = vector->size();
+
+    return true;
+}
+
+extern "C" void obx_fbr_read_row(const struct OBX_fbr* _Nonnull self, const struct OBX_row_field* _Nonnull fields,
+                                 size_t count, void* _Nonnull row, uint8_t* _Nullable outPresence) {
+    // Same lookup as Table::GetOptionalFieldOffset(), but with the vtable resolved once for all fields
+    const uint8_t* table = reinterpret_cast<const uint8_t*>(self);
+    const uint8_t* vtable = self->GetVTable();
+    const flatbuffers::voffset_t vtableSize = flatbuffers::ReadScalar<flatbuffers::voffset_t>(vtable);
+    uint8_t* rowBytes = static_cast<uint8_t*>(row);
+    if (outPresence) memset(outPresence, 0, (count + 7) / 8);
+
+    for (size_t i = 0; i < count; ++i) {
+        const OBX_row_field& field = fields[i];
+        const size_t size = obx_scalar_size(field.type);
+        assert(size && "Row layouts may only contain scalar properties");
+        flatbuffers::voffset_t fieldOffset = field.propertyOffset < vtableSize
+                ? flatbuffers::ReadScalar<flatbuffers::voffset_t>(vtable + field.propertyOffset) : 0;
+        if (fieldOffset) {
+            memcpy(rowBytes + field.rowOffset, table + fieldOffset, size);
+            if (outPresence) outPresence[i >> 3] |= uint8_t(1u << (i & 7));
+        } else {
+            memset(rowBytes + field.rowOffset, 0, size);
+        }
+    }
+}
+
 /// Similar to OBX_string_array(_internal): we need an accessible vector to manage the memory for the string pointers.
 struct OBX_flat_strings_internal {
     const char** items;
@@ -483,3 +1914,604 @@ extern "C" OBX_flat_strings* _Nullable obx_fbr_read_strings(const struct OBX_fbr
 extern "C" void obx_flat_strings_free(struct OBX_flat_strings* _Nullable strings) {
     delete (OBX_flat_strings_internal*) strings;
 }
+
+extern "C" bool obx_fbr_read_strings_count(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                           size_t* _Nonnull outCount) {
+    const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *vector =
+        self->GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(propertyOffset);
+    if (!vector) {
+        return false;
+    }
+    *outCount = vector->size();
+    return true;
+}
+
+extern "C" bool obx_fbr_read_strings_at(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, size_t index,
+                                        const char* _Nullable * _Nonnull outString, size_t* _Nonnull outLength) {
+    const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *vector =
+        self->GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(propertyOffset);
+    if (!vector || index >= vector->size()) {
+        return false;
+    }
+    const flatbuffers::String *str = vector->Get(static_cast<flatbuffers::uoffset_t>(index));
+    *outString = str->c_str();
+    *outLength = str->size();
+    return true;
+}
+
+extern "C" bool obx_fbr_read_string_spans(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                          struct OBX_string_span* _Nullable outSpans, size_t capacity,
+                                          const char* _Nullable * _Nonnull outBase) {
+    const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *vector =
+        self->GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(propertyOffset);
+    if (!vector || capacity < vector->size()) {
+        return false;
+    }
+    // Strings are stored after the vector referencing them, so offsets relative to its data are never negative
+    const uint8_t* base = vector->Data();
+    for (flatbuffers::uoffset_t i = 0; i < vector->size(); ++i) {
+        const flatbuffers::String *str = vector->Get(i);
+        outSpans[i].offset = static_cast<uint32_t>(str->Data() - base);
+        outSpans[i].length = str->size();
+    }
+    *outBase = reinterpret_cast<const char*>(base);
+    return true;
+}
+
+#pragma mark - Patching
+
+extern "C" struct OBX_fbr* _Nullable obx_fbb_patch_start(struct OBX_fbb* _Nonnull self, const void* _Nonnull bytes,
+                                                         size_t size) {
+    try {
+        const uint8_t* data = static_cast<const uint8_t*>(bytes);
+        self->patchBuffer.assign(data, data + size);
+    } catch(std::bad_alloc& err) {
+        fprintf(stderr, "Unexpected bad_alloc error copying object to patch.");
+        return nullptr;
+    }
+    return reinterpret_cast<struct OBX_fbr*>(flatbuffers::GetMutableRoot<flatbuffers::Table>(self->patchBuffer.data()));
+}
+
+extern "C" void obx_fbb_patch_get(struct OBX_fbb* _Nonnull self, OBX_bytes* _Nonnull outBytes) {
+    outBytes->data = self->patchBuffer.data();
+    outBytes->size = self->patchBuffer.size();
+}
+
+extern "C" bool obx_fbb_is_collected(struct OBX_fbb* _Nonnull self, uint16_t propertyOffset) {
+    return obx_is_started_fast(self) && self->fbb.HasField(propertyOffset);
+}
+
+// Only present fields can be set in place; an absent field has no space reserved in the table.
+template<typename T>
+static inline bool obx_fbr_patch(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, T value) {
+    return self->CheckField(propertyOffset) && self->SetField<T>(propertyOffset, value, value);
+}
+
+extern "C" bool obx_fbr_patch_bool(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, bool value) {
+    return obx_fbr_patch<bool>(self, propertyOffset, value);
+}
+
+extern "C" bool obx_fbr_patch_int8(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, int8_t value) {
+    return obx_fbr_patch<int8_t>(self, propertyOffset, value);
+}
+
+extern "C" bool obx_fbr_patch_int16(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, int16_t value) {
+    return obx_fbr_patch<int16_t>(self, propertyOffset, value);
+}
+
+extern "C" bool obx_fbr_patch_int32(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, int32_t value) {
+    return obx_fbr_patch<int32_t>(self, propertyOffset, value);
+}
+
+extern "C" bool obx_fbr_patch_int64(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, int64_t value) {
+    return obx_fbr_patch<int64_t>(self, propertyOffset, value);
+}
+
+extern "C" bool obx_fbr_patch_uint8(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, uint8_t value) {
+    return obx_fbr_patch<uint8_t>(self, propertyOffset, value);
+}
+
+extern "C" bool obx_fbr_patch_uint16(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, uint16_t value) {
+    return obx_fbr_patch<uint16_t>(self, propertyOffset, value);
+}
+
+extern "C" bool obx_fbr_patch_uint32(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, uint32_t value) {
+    return obx_fbr_patch<uint32_t>(self, propertyOffset, value);
+}
+
+extern "C" bool obx_fbr_patch_uint64(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, uint64_t value) {
+    return obx_fbr_patch<uint64_t>(self, propertyOffset, value);
+}
+
+extern "C" bool obx_fbr_patch_float(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, float value) {
+    return obx_fbr_patch<float>(self, propertyOffset, value);
+}
+
+extern "C" bool obx_fbr_patch_double(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, double value) {
+    return obx_fbr_patch<double>(self, propertyOffset, value);
+}
+
+#pragma mark - FlexBuffers
+
+extern "C" void obx_fbb_flex_null(struct OBX_fbb* _Nonnull self) {
+    self->flex.addNull();
+}
+
+extern "C" void obx_fbb_flex_bool(struct OBX_fbb* _Nonnull self, bool value) {
+    self->flex.addBool(value);
+}
+
+extern "C" void obx_fbb_flex_int(struct OBX_fbb* _Nonnull self, int64_t value) {
+    self->flex.addInt(value);
+}
+
+extern "C" void obx_fbb_flex_uint(struct OBX_fbb* _Nonnull self, uint64_t value) {
+    self->flex.addUInt(value);
+}
+
+extern "C" void obx_fbb_flex_double(struct OBX_fbb* _Nonnull self, double value) {
+    self->flex.addDouble(value);
+}
+
+extern "C" void obx_fbb_flex_string(struct OBX_fbb* _Nonnull self, const char* _Nonnull string, size_t length) {
+    self->flex.addString(string, length);
+}
+
+extern "C" void obx_fbb_flex_blob(struct OBX_fbb* _Nonnull self, const void* _Nonnull data, size_t size) {
+    self->flex.addBlob(data, size);
+}
+
+extern "C" void obx_fbb_flex_key(struct OBX_fbb* _Nonnull self, const char* _Nonnull key, size_t length) {
+    assert(memchr(key, 0, length) == nullptr && "Map keys must not contain zero bytes");
+    self->flex.addKey(key, length);
+}
+
+extern "C" void obx_fbb_flex_vector_start(struct OBX_fbb* _Nonnull self) {
+    self->flex.startContainer();
+}
+
+extern "C" void obx_fbb_flex_vector_end(struct OBX_fbb* _Nonnull self) {
+    self->flex.endVector();
+}
+
+extern "C" void obx_fbb_flex_map_start(struct OBX_fbb* _Nonnull self) {
+    self->flex.startContainer();
+}
+
+extern "C" void obx_fbb_flex_map_end(struct OBX_fbb* _Nonnull self) {
+    self->flex.endMap();
+}
+
+extern "C" OBXDataOffset obx_fbb_flex_finish(struct OBX_fbb* _Nonnull self) {
+    OBXDataOffset result = 0;
+    try {
+        self->flex.finish();
+        result = obx_fbb_prepare_bytes(self, self->flex.data(), self->flex.size());
+    } catch(std::bad_alloc& err) {
+        fprintf(stderr, "Unexpected bad_alloc error collecting FlexBuffer.");
+        result = 0;
+    }
+    self->flex.clear();
+    return result;
+}
+
+// FlexBuffers stored as a byte vector are not necessarily aligned; read scalars using memcpy to avoid unaligned access.
+template<typename T>
+static inline T obx_flex_read_scalar(const uint8_t* data) {
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return flatbuffers::EndianScalar(value);
+}
+
+static inline uint64_t obx_flex_read_uint(const uint8_t* data, uint8_t byteWidth) {
+    switch (byteWidth) {
+        case 1: return obx_flex_read_scalar<uint8_t>(data);
+        case 2: return obx_flex_read_scalar<uint16_t>(data);
+        case 4: return obx_flex_read_scalar<uint32_t>(data);
+        default: return obx_flex_read_scalar<uint64_t>(data);
+    }
+}
+
+static inline int64_t obx_flex_read_int(const uint8_t* data, uint8_t byteWidth) {
+    switch (byteWidth) {
+        case 1: return obx_flex_read_scalar<int8_t>(data);
+        case 2: return obx_flex_read_scalar<int16_t>(data);
+        case 4: return obx_flex_read_scalar<int32_t>(data);
+        default: return obx_flex_read_scalar<int64_t>(data);
+    }
+}
+
+static inline double obx_flex_read_double(const uint8_t* data, uint8_t byteWidth) {
+    if (byteWidth == 4) return obx_flex_read_scalar<float>(data);
+    if (byteWidth == 8) return obx_flex_read_scalar<double>(data);
+    return 0;  // Half and quarter precision floats are not supported by FlexBuffers either
+}
+
+static inline const uint8_t* obx_flex_data(const struct OBX_flex_ref* _Nonnull ref) {
+    return static_cast<const uint8_t*>(ref->data);
+}
+
+// Offset types store an offset (with the parent's width) pointing back to the actual value.
+static inline const uint8_t* obx_flex_indirect(const struct OBX_flex_ref* _Nonnull ref) {
+    const uint8_t* data = obx_flex_data(ref);
+    return data - obx_flex_read_uint(data, ref->parent_width);
+}
+
+static inline bool obx_flex_is_fixed_typed_vector(uint8_t type) {
+    return type >= obxflex::TYPE_VECTOR_INT2 && type <= obxflex::TYPE_VECTOR_FLOAT4;
+}
+
+static inline bool obx_flex_is_typed_vector(uint8_t type) {
+    return (type >= obxflex::TYPE_VECTOR_INT && type <= obxflex::TYPE_VECTOR_STRING_DEPRECATED) ||
+           type == obxflex::TYPE_VECTOR_BOOL;
+}
+
+static inline bool obx_flex_is_vector(uint8_t type) {
+    return type == obxflex::TYPE_VECTOR || type == obxflex::TYPE_MAP || obx_flex_is_typed_vector(type) ||
+           obx_flex_is_fixed_typed_vector(type);
+}
+
+extern "C" bool obx_flex_root(const void* _Nonnull data, size_t size, struct OBX_flex_ref* _Nonnull outRef) {
+    if (size < 3) return false;
+    const uint8_t* end = static_cast<const uint8_t*>(data) + size;
+    uint8_t byteWidth = end[-1];
+    uint8_t packedType = end[-2];
+    if (byteWidth != 1 && byteWidth != 2 && byteWidth != 4 && byteWidth != 8) return false;
+    if (size < 2u + byteWidth) return false;
+    outRef->data = end - 2 - byteWidth;
+    outRef->parent_width = byteWidth;
+    outRef->byte_width = static_cast<uint8_t>(1u << (packedType & 3));
+    outRef->type = static_cast<uint8_t>(packedType >> 2);
+    return true;
+}
+
+extern "C" bool obx_fbr_read_flex(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                  struct OBX_flex_ref* _Nonnull outRef) {
+    const flatbuffers::Vector<uint8_t> *vector = self->GetPointer<const flatbuffers::Vector<uint8_t> *>(propertyOffset);
+    if (!vector) {
+        return false;
+    }
+    return obx_flex_root(vector->data(), vector->size(), outRef);
+}
+
+extern "C" OBXFlexType obx_flex_type(const struct OBX_flex_ref* _Nonnull ref) {
+    switch (ref->type) {
+        case obxflex::TYPE_NULL: return OBXFlexType_Null;
+        case obxflex::TYPE_BOOL: return OBXFlexType_Bool;
+        case obxflex::TYPE_INT:
+        case obxflex::TYPE_INDIRECT_INT: return OBXFlexType_Int;
+        case obxflex::TYPE_UINT:
+        case obxflex::TYPE_INDIRECT_UINT: return OBXFlexType_UInt;
+        case obxflex::TYPE_FLOAT:
+        case obxflex::TYPE_INDIRECT_FLOAT: return OBXFlexType_Float;
+        case obxflex::TYPE_STRING: return OBXFlexType_String;
+        case obxflex::TYPE_KEY: return OBXFlexType_Key;
+        case obxflex::TYPE_BLOB: return OBXFlexType_Blob;
+        case obxflex::TYPE_MAP: return OBXFlexType_Map;
+        default: return obx_flex_is_vector(ref->type) ? OBXFlexType_Vector : OBXFlexType_Null;
+    }
+}
+
+extern "C" bool obx_flex_as_bool(const struct OBX_flex_ref* _Nonnull ref) {
+    if (ref->type == obxflex::TYPE_BOOL) return obx_flex_read_uint(obx_flex_data(ref), ref->parent_width) != 0;
+    return obx_flex_as_int(ref) != 0;
+}
+
+extern "C" int64_t obx_flex_as_int(const struct OBX_flex_ref* _Nonnull ref) {
+    switch (ref->type) {
+        case obxflex::TYPE_INT: return obx_flex_read_int(obx_flex_data(ref), ref->parent_width);
+        case obxflex::TYPE_INDIRECT_INT: return obx_flex_read_int(obx_flex_indirect(ref), ref->byte_width);
+        case obxflex::TYPE_UINT:
+        case obxflex::TYPE_BOOL: return static_cast<int64_t>(obx_flex_read_uint(obx_flex_data(ref), ref->parent_width));
+        case obxflex::TYPE_INDIRECT_UINT:
+            return static_cast<int64_t>(obx_flex_read_uint(obx_flex_indirect(ref), ref->byte_width));
+        case obxflex::TYPE_FLOAT:
+        case obxflex::TYPE_INDIRECT_FLOAT: return static_cast<int64_t>(obx_flex_as_double(ref));
+        default: return 0;
+    }
+}
+
+extern "C" uint64_t obx_flex_as_uint(const struct OBX_flex_ref* _Nonnull ref) {
+    switch (ref->type) {
+        case obxflex::TYPE_UINT:
+        case obxflex::TYPE_BOOL: return obx_flex_read_uint(obx_flex_data(ref), ref->parent_width);
+        case obxflex::TYPE_INDIRECT_UINT: return obx_flex_read_uint(obx_flex_indirect(ref), ref->byte_width);
+        case obxflex::TYPE_FLOAT:
+        case obxflex::TYPE_INDIRECT_FLOAT: return static_cast<uint64_t>(obx_flex_as_double(ref));
+        default: return static_cast<uint64_t>(obx_flex_as_int(ref));
+    }
+}
+
+extern "C" double obx_flex_as_double(const struct OBX_flex_ref* _Nonnull ref) {
+    switch (ref->type) {
+        case obxflex::TYPE_FLOAT: return obx_flex_read_double(obx_flex_data(ref), ref->parent_width);
+        case obxflex::TYPE_INDIRECT_FLOAT: return obx_flex_read_double(obx_flex_indirect(ref), ref->byte_width);
+        case obxflex::TYPE_UINT:
+        case obxflex::TYPE_INDIRECT_UINT: return static_cast<double>(obx_flex_as_uint(ref));
+        default: return static_cast<double>(obx_flex_as_int(ref));
+    }
+}
+
+extern "C" const char* _Nullable obx_flex_as_string(const struct OBX_flex_ref* _Nonnull ref, size_t* _Nonnull outLength) {
+    if (ref->type == obxflex::TYPE_KEY) {
+        const char* key = reinterpret_cast<const char*>(obx_flex_indirect(ref));
+        *outLength = strlen(key);
+        return key;
+    }
+    if (ref->type != obxflex::TYPE_STRING) return nullptr;
+    const uint8_t* string = obx_flex_indirect(ref);
+    *outLength = obx_flex_read_uint(string - ref->byte_width, ref->byte_width);
+    return reinterpret_cast<const char*>(string);
+}
+
+extern "C" bool obx_flex_as_blob(const struct OBX_flex_ref* _Nonnull ref, OBX_bytes* _Nonnull outBytes) {
+    if (ref->type != obxflex::TYPE_BLOB && ref->type != obxflex::TYPE_STRING) return false;
+    const uint8_t* blob = obx_flex_indirect(ref);
+    outBytes->data = blob;
+    outBytes->size = obx_flex_read_uint(blob - ref->byte_width, ref->byte_width);
+    return true;
+}
+
+extern "C" size_t obx_flex_count(const struct OBX_flex_ref* _Nonnull ref) {
+    if (obx_flex_is_fixed_typed_vector(ref->type)) return (ref->type - obxflex::TYPE_VECTOR_INT2) / 3 + 2;
+    if (!obx_flex_is_vector(ref->type)) return 0;
+    const uint8_t* vector = obx_flex_indirect(ref);
+    return obx_flex_read_uint(vector - ref->byte_width, ref->byte_width);
+}
+
+extern "C" bool obx_flex_at(const struct OBX_flex_ref* _Nonnull ref, size_t index, struct OBX_flex_ref* _Nonnull outRef) {
+    size_t count = obx_flex_count(ref);
+    if (index >= count) return false;
+    const uint8_t* vector = obx_flex_indirect(ref);
+    outRef->data = vector + index * ref->byte_width;
+    outRef->parent_width = ref->byte_width;
+    if (ref->type == obxflex::TYPE_VECTOR || ref->type == obxflex::TYPE_MAP) {
+        // Untyped: the packed type of each element follows the elements
+        uint8_t packedType = vector[count * ref->byte_width + index];
+        outRef->byte_width = static_cast<uint8_t>(1u << (packedType & 3));
+        outRef->type = static_cast<uint8_t>(packedType >> 2);
+    } else {
+        outRef->byte_width = 1;
+        if (ref->type == obxflex::TYPE_VECTOR_BOOL) {
+            outRef->type = obxflex::TYPE_BOOL;
+        } else if (obx_flex_is_fixed_typed_vector(ref->type)) {
+            outRef->type = static_cast<uint8_t>((ref->type - obxflex::TYPE_VECTOR_INT2) % 3 + obxflex::TYPE_INT);
+        } else {
+            outRef->type = static_cast<uint8_t>(ref->type - obxflex::TYPE_VECTOR_INT + obxflex::TYPE_INT);
+        }
+    }
+    return true;
+}
+
+extern "C" bool obx_flex_key_at(const struct OBX_flex_ref* _Nonnull ref, size_t index,
+                                const char* _Nullable * _Nonnull outKey, size_t* _Nonnull outLength) {
+    if (ref->type != obxflex::TYPE_MAP || index >= obx_flex_count(ref)) return false;
+    const uint8_t* map = obx_flex_indirect(ref);
+    uint8_t width = ref->byte_width;
+    const uint8_t* keysOffset = map - 3 * width;
+    const uint8_t* keys = keysOffset - obx_flex_read_uint(keysOffset, width);
+    uint8_t keysWidth = static_cast<uint8_t>(obx_flex_read_uint(map - 2 * width, width));
+    const uint8_t* keyOffset = keys + index * keysWidth;
+    *outKey = reinterpret_cast<const char*>(keyOffset - obx_flex_read_uint(keyOffset, keysWidth));
+    *outLength = strlen(*outKey);
+    return true;
+}
+
+extern "C" bool obx_flex_lookup(const struct OBX_flex_ref* _Nonnull ref, const char* _Nonnull key, size_t length,
+                                struct OBX_flex_ref* _Nonnull outRef) {
+    if (ref->type != obxflex::TYPE_MAP) return false;
+    // Keys are sorted, so a binary search does; keys are zero-terminated, the given key may be not.
+    size_t low = 0;
+    size_t high = obx_flex_count(ref);
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        const char* midKey = nullptr;
+        size_t midLength = 0;
+        obx_flex_key_at(ref, mid, &midKey, &midLength);
+        int cmp = strncmp(midKey, key, length);
+        if (cmp == 0 && midLength != length) cmp = midLength < length ? -1 : 1;
+        if (cmp == 0) return obx_flex_at(ref, mid, outRef);
+        if (cmp < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return false;
+}
+
+
+#pragma mark - Quantized Vectors
+
+namespace obxquant {
+const size_t INT8_HEADER_SIZE = sizeof(float);  // The scale precedes the int8 values
+
+// IEEE half precision conversion rounding to nearest even (by F. Giesen); used for vector tails without SIMD support.
+inline uint16_t floatToHalf(float value) {
+    const uint32_t f32Infinity = 255u << 23;
+    const uint32_t f16Max = (127u + 16) << 23;
+    const uint32_t denormMagicBits = ((127u - 15) + (23 - 10) + 1) << 23;
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+    uint16_t result;
+    if (bits >= f16Max) {
+        result = bits > f32Infinity ? 0x7E00 : 0x7C00;  // NaN or infinity
+    } else if (bits < (113u << 23)) {  // Subnormal or zero: let the FPU round by adding a magic number
+        float denormMagic, f;
+        memcpy(&denormMagic, &denormMagicBits, sizeof(denormMagic));
+        memcpy(&f, &bits, sizeof(f));
+        f += denormMagic;
+        memcpy(&bits, &f, sizeof(bits));
+        result = static_cast<uint16_t>(bits - denormMagicBits);
+    } else {
+        uint32_t mantissaOdd = (bits >> 13) & 1;
+        bits += ((15u - 127) << 23) + 0xFFF;
+        bits += mantissaOdd;
+        result = static_cast<uint16_t>(bits >> 13);
+    }
+    return static_cast<uint16_t>(result | (sign >> 16));
+}
+
+inline float halfToFloat(uint16_t half) {
+    const uint32_t shiftedExponent = 0x7C00u << 13;
+    const uint32_t magicBits = 113u << 23;
+    uint32_t bits = (half & 0x7FFFu) << 13;
+    uint32_t exponent = shiftedExponent & bits;
+    bits += (127u - 15) << 23;
+    if (exponent == shiftedExponent) {
+        bits += (128u - 16) << 23;  // Infinity or NaN
+    } else if (exponent == 0) {  // Subnormal or zero
+        float magic, f;
+        memcpy(&magic, &magicBits, sizeof(magic));
+        bits += 1u << 23;
+        memcpy(&f, &bits, sizeof(f));
+        f -= magic;
+        memcpy(&bits, &f, sizeof(bits));
+    }
+    bits |= static_cast<uint32_t>(half & 0x8000u) << 16;
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+void toHalf(const float* in, uint16_t* out, size_t count) {
+    size_t i = 0;
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 4 <= count; i += 4) {
+        vst1_u16(out + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(in + i))));
+    }
+#elif defined(__F16C__) && defined(__AVX__)
+    for (; i + 8 <= count; i += 8) {
+        __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), halves);
+    }
+#endif
+    for (; i < count; ++i) out[i] = floatToHalf(in[i]);
+}
+
+void fromHalf(const uint16_t* in, float* out, size_t count) {
+    size_t i = 0;
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(in + i))));
+    }
+#elif defined(__F16C__) && defined(__AVX__)
+    for (; i + 8 <= count; i += 8) {
+        __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(halves));
+    }
+#endif
+    for (; i < count; ++i) out[i] = halfToFloat(in[i]);
+}
+
+// Symmetric int8 quantization with one scale per vector, i.e. value = int8 * scale.
+// The loops are branch-free so that compilers vectorize them.
+float toInt8(const float* in, int8_t* out, size_t count) {
+    float maxAbs = 0;
+    for (size_t i = 0; i < count; ++i) {
+        float magnitude = std::fabs(in[i]);
+        maxAbs = magnitude <= FLT_MAX && magnitude > maxAbs ? magnitude : maxAbs;  // Ignores infinity and NaN
+    }
+    float scale = maxAbs / 127;
+    float inverse = maxAbs > 0 ? 127 / maxAbs : 0;
+    for (size_t i = 0; i < count; ++i) {
+        float scaled = in[i] * inverse;
+        scaled = scaled == scaled ? scaled : 0;  // NaN
+        scaled = std::min(std::max(scaled, -127.0f), 127.0f);
+        out[i] = static_cast<int8_t>(scaled + (scaled >= 0 ? 0.5f : -0.5f));
+    }
+    return scale;
+}
+
+void fromInt8(const int8_t* in, float scale, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) out[i] = in[i] * scale;
+}
+}
+
+extern "C" OBXDataOffset obx_fbb_prepare_floats_encoded(struct OBX_fbb* _Nonnull self, const float* _Nonnull floats,
+                                                        size_t count, OBXVectorEncoding encoding) {
+    GUARD_IS_COLLECTING;
+    assert(!obx_is_started_fast(self)); // Must be collected before scalars.
+
+    OBXDataOffset result = 0;
+    try {
+        switch (encoding) {
+            case OBXVectorEncoding_Float16: {
+                uint16_t* halves = nullptr;
+                result = self->fbb.CreateUninitializedVector(count, &halves).o;
+                obxquant::toHalf(floats, halves, count);
+                break;
+            }
+            case OBXVectorEncoding_Int8: {
+                uint8_t* bytes = nullptr;
+                result = self->fbb.CreateUninitializedVector(obxquant::INT8_HEADER_SIZE + count, &bytes).o;
+                float scale = obxquant::toInt8(floats, reinterpret_cast<int8_t*>(bytes + obxquant::INT8_HEADER_SIZE),
+                                               count);
+                flatbuffers::WriteScalar(bytes, scale);
+                break;
+            }
+            default:
+                result = self->fbb.CreateVector(floats, count).o;
+        }
+    } catch(std::bad_alloc& err) {
+        fprintf(stderr, "Unexpected bad_alloc error collecting encoded float vector.");
+        result = 0;
+    }
+    return result;
+}
+
+extern "C" bool obx_fbr_read_floats_count(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                          OBXVectorEncoding encoding, size_t* _Nonnull outCount) {
+    switch (encoding) {
+        case OBXVectorEncoding_Float16: {
+            auto vector = self->GetPointer<const flatbuffers::Vector<uint16_t>*>(propertyOffset);
+            if (!vector) return false;
+            *outCount = vector->size();
+            return true;
+        }
+        case OBXVectorEncoding_Int8: {
+            auto vector = self->GetPointer<const flatbuffers::Vector<uint8_t>*>(propertyOffset);
+            if (!vector) return false;
+            *outCount = vector->size() > obxquant::INT8_HEADER_SIZE ? vector->size() - obxquant::INT8_HEADER_SIZE : 0;
+            return true;
+        }
+        default: {
+            auto vector = self->GetPointer<const flatbuffers::Vector<float>*>(propertyOffset);
+            if (!vector) return false;
+            *outCount = vector->size();
+            return true;
+        }
+    }
+}
+
+extern "C" size_t obx_fbr_read_floats_decoded(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                              OBXVectorEncoding encoding, float* _Nonnull outFloats, size_t capacity) {
+    switch (encoding) {
+        case OBXVectorEncoding_Float16: {
+            auto vector = self->GetPointer<const flatbuffers::Vector<uint16_t>*>(propertyOffset);
+            if (!vector) return 0;
+            size_t count = std::min<size_t>(vector->size(), capacity);
+            obxquant::fromHalf(vector->data(), outFloats, count);
+            return count;
+        }
+        case OBXVectorEncoding_Int8: {
+            auto vector = self->GetPointer<const flatbuffers::Vector<uint8_t>*>(propertyOffset);
+            if (!vector || vector->size() < obxquant::INT8_HEADER_SIZE) return 0;
+            size_t count = std::min<size_t>(vector->size() - obxquant::INT8_HEADER_SIZE, capacity);
+            float scale;
+            memcpy(&scale, vector->data(), sizeof(scale));  // Little endian like all FlatBuffers scalars
+            const int8_t* values = reinterpret_cast<const int8_t*>(vector->data() + obxquant::INT8_HEADER_SIZE);
+            obxquant::fromInt8(values, scale, outFloats, count);
+            return count;
+        }
+        default: {
+            auto vector = self->GetPointer<const flatbuffers::Vector<float>*>(propertyOffset);
+            if (!vector) return 0;
+            size_t count = std::min<size_t>(vector->size(), capacity);
+            if (count > 0) memcpy(outFloats, vector->data(), count * sizeof(float));
+            return count;
+        }
+    }
+}
@@ -34,6 +34,73 @@ struct OBX_fbr;
 /// the collector interface to C/Swift.
 typedef uint32_t OBXDataOffset;
 
+/// Describes one scalar property of an entity for collecting (obx_fbb_collect_row()) or reading all scalars of an
+/// object with a single call. An entity's layout is an array of these, one for each scalar property; the values are
+/// located in a packed "row" struct provided by the caller.
+struct OBX_row_field {
+    /// The property's FlatBuffers field offset, i.e. 2 + 2 * property ID (like propertyOffset in other calls).
+    uint16_t propertyOffset;
+    /// The OBXPropertyType of the property; one of the scalar types (Bool to Double, Date, Relation or DateNano).
+    uint16_t type;
+    /// Byte offset of the value within the row struct; must be aligned to the value's size.
+    uint32_t rowOffset;
+};
+
+/// Memory statistics of a FlatBuffer builder, see obx_fbb_stats().
+struct OBX_fbb_stats {
+    /// Number of memory blocks the builder's arena requested from the heap over its lifetime.
+    uint64_t heap_allocations;
+    /// Number of times the buffer had to grow while collecting an object, i.e. a reallocation (usually with a copy).
+    /// Also counts growing to a learned size when starting an object, see obx_fbb_start_entity().
+    uint64_t grow_events;
+    /// Bytes held by the builder's arena, either in use or kept for reuse.
+    size_t arena_bytes;
+    /// Bytes of the arena currently in use by all of the builder's buffers (rounded up to the arena's block sizes),
+    /// including the FlexBuffers ones (flex_capacity). The buffers, and thus these bytes, are kept across
+    /// obx_fbb_clear().
+    size_t in_use_bytes;
+    /// Capacity of the buffer objects are built in; retained across obx_fbb_clear().
+    size_t capacity;
+    /// Capacity of the buffers flex properties are built in before they are prepared; retained across obx_fbb_clear().
+    size_t flex_capacity;
+    /// Number of finished objects whose vtable was taken from the builder's vtable cache, which survives clearing.
+    uint64_t vtable_cache_hits;
+    /// Number of finished objects whose vtable had to be built (and was then cached).
+    uint64_t vtable_cache_misses;
+};
+
+/// Object sizes learned for an entity type, see obx_fbb_size_hint().
+struct OBX_fbb_size_hint {
+    /// Moving average of the sizes of finished objects of this type.
+    size_t average_size;
+    /// The buffer size reserved when starting to collect an object of this type (some headroom over the average).
+    size_t reserve_size;
+    /// Number of finished objects the average was learned from.
+    uint64_t object_count;
+    /// Number of times a buffer had to grow while collecting an object of this type, i.e. the reserved size was too
+    /// small (or not learned yet); stays constant in a steady state.
+    uint64_t reallocations;
+};
+
+/// Strings and byte vectors prepared with compression are only compressed if they have at least this many bytes.
+#define OBX_FBB_COMPRESSION_MIN_SIZE 4096
+
+/// Process-wide statistics of compressed strings and byte vectors, see obx_compression_stats().
+struct OBX_compression_stats {
+    /// Number of payloads stored compressed.
+    uint64_t compressed_count;
+    /// Number of payloads stored uncompressed, because compressing them would not save enough space.
+    uint64_t skipped_count;
+    /// Total size of the compressed payloads before compression.
+    uint64_t uncompressed_bytes;
+    /// Total size of the compressed payloads as stored (including their headers).
+    uint64_t compressed_bytes;
+    /// Number of payloads decompressed while reading.
+    uint64_t decompressed_count;
+    /// Total time spent decompressing payloads while reading.
+    uint64_t decode_nanos;
+};
+
 
 #pragma mark - Writing
     
@@ -43,6 +110,22 @@ struct OBX_fbb* _Nonnull obx_fbb_create();
 /// Dispose of the memory used by a FlatBuffer builder created using obx_fbb_create() once you are done with it.
 void obx_fbb_free(struct OBX_fbb* _Nonnull self);
 
+/// Get a builder from the calling thread's pool, or a new one if the pool is empty (e.g. for nested puts).
+/// Give it back using obx_fbb_release() on the same thread; do not free it.
+struct OBX_fbb* _Nonnull obx_fbb_acquire();
+
+/// Give a builder acquired via obx_fbb_acquire() back to the calling thread's pool, which keeps a few of them (for
+/// nesting) until the thread exits; others are freed. The builder must be cleared and not collecting.
+void obx_fbb_release(struct OBX_fbb* _Nonnull self);
+
+/// Associate a wrapper object with the builder, e.g. to reuse the same wrapper whenever a pooled builder is acquired.
+/// @param releaseOwner called with the owner when the builder is freed (e.g. when its thread exits).
+void obx_fbb_set_owner(struct OBX_fbb* _Nonnull self, void* _Nullable owner,
+                       void (* _Nullable releaseOwner)(void* _Nonnull owner));
+
+/// @returns the owner set using obx_fbb_set_owner(), if any.
+void* _Nullable obx_fbb_owner(struct OBX_fbb* _Nonnull self);
+
 /// @param self the flatbuffer to complete and whose data you want returned.
 /// @param outBytes A buffer referencing the built FlatBuffer data. This buffer is owned by the flatbuffer, do not free it!
 void obx_fbb_finish(struct OBX_fbb* _Nonnull self, struct OBX_bytes * _Nonnull outBytes);
@@ -58,8 +141,50 @@ bool obx_fbb_did_start(struct OBX_fbb* _Nonnull self);
 /// Start the collection, if not already started.
 void obx_fbb_ensure_started(struct OBX_fbb* _Nonnull self);
 
+/// Reset the builder for the next object. Keeps the buffer memory (high-water mark) for reuse.
 void obx_fbb_clear(struct OBX_fbb* _Nonnull self);
 
+/// Tell the builder the entity type of the object to be collected next; call right after obx_fbb_clear().
+/// Reserves the size learned from previously finished objects of this type (shared by all builders), so collecting
+/// does not have to grow the buffer repeatedly, and learns from the size of the finished object.
+void obx_fbb_start_entity(struct OBX_fbb* _Nonnull self, obx_schema_id entitySchemaId);
+
+/// Get the object sizes learned for the given entity type (see obx_fbb_start_entity()), e.g. for tuning.
+/// @return false if sizes are not learned for this entity ID (only IDs up to 1023 are supported).
+bool obx_fbb_size_hint(obx_schema_id entitySchemaId, struct OBX_fbb_size_hint* _Nonnull outHint);
+
+/// Get memory statistics of the given builder, e.g. to verify that collecting objects does not allocate anymore.
+void obx_fbb_stats(struct OBX_fbb* _Nonnull self, struct OBX_fbb_stats* _Nonnull outStats);
+
+/// Whether the finished object equals the given stored object byte for byte, e.g. to detect unchanged objects.
+bool obx_fbb_matches(struct OBX_fbb* _Nonnull self, const void* _Nonnull stored, size_t storedSize);
+
+#pragma mark - Batches
+
+/// Finish the collected object and append it to the builder's batch, using the given ID for putting it.
+/// Batched objects are stored back to back in one builder-owned arena; the builder is cleared for the next object.
+/// Use obx_fbb_batch_put() once all objects of a batch were added.
+void obx_fbb_batch_add(struct OBX_fbb* _Nonnull self, obx_id id);
+
+/// Like obx_fbb_batch_add(), but only adds the object if it differs from the given stored object (see
+/// obx_fbb_matches()). The builder is cleared in any case.
+/// @param stored the currently stored object with the given ID, or NULL if there is none.
+/// @returns true if the object was added, false if it is unchanged.
+bool obx_fbb_batch_add_changed(struct OBX_fbb* _Nonnull self, obx_id id, const void* _Nullable stored,
+                               size_t storedSize);
+
+/// @returns the number of objects added to the batch since the last obx_fbb_batch_clear().
+size_t obx_fbb_batch_count(struct OBX_fbb* _Nonnull self);
+
+/// Put all batched objects using the given cursor (a single call for the whole batch).
+/// @returns the error of the first put that failed; following objects are not put.
+obx_err obx_fbb_batch_put(struct OBX_fbb* _Nonnull self, OBX_cursor* _Nonnull cursor, OBXPutMode mode);
+
+/// Remove all objects from the batch; keeps the memory for the next batch.
+void obx_fbb_batch_clear(struct OBX_fbb* _Nonnull self);
+
+#pragma mark - Collecting
+
 /* Handle NULL values by just not collecting a property. */
 void obx_fbb_collect_bool(struct OBX_fbb* _Nonnull self, bool value, uint16_t propertyOffset);
 
@@ -76,18 +201,66 @@ void obx_fbb_collect_uint64(struct OBX_fbb* _Nonnull self, uint64_t value, uint1
 void obx_fbb_collect_float(struct OBX_fbb* _Nonnull self, float value, uint16_t propertyOffset);
 void obx_fbb_collect_double(struct OBX_fbb* _Nonnull self, double value, uint16_t propertyOffset);
 
+/// Collect all given scalar properties from the given row struct with a single call, instead of one call per property.
+/// @param fields the layout, one entry per scalar property (see OBX_row_field); collected in the given order.
+/// @param row the packed struct holding the values at the offsets given by the layout.
+/// @param presence optional bitmap with one bit per layout entry (LSB first); fields with a cleared bit are NULL and
+///        not collected. Pass NULL if all fields are present.
+void obx_fbb_collect_row(struct OBX_fbb* _Nonnull self, const struct OBX_row_field* _Nonnull fields, size_t count,
+                         const void* _Nonnull row, const uint8_t* _Nullable presence);
+
 void obx_fbb_collect_data_offset(struct OBX_fbb* _Nonnull self, OBXDataOffset dataOffset, uint16_t propertyOffset);
 
 OBXDataOffset obx_fbb_prepare_string(struct OBX_fbb* _Nonnull self, const char* _Nonnull string);
 
+/// Like obx_fbb_prepare_string(), but takes the length of the UTF-8 string (in bytes) instead of scanning for the
+/// terminating zero; the string does not have to be zero-terminated.
+OBXDataOffset obx_fbb_prepare_string_n(struct OBX_fbb* _Nonnull self, const char* _Nonnull string, size_t length);
+
 OBXDataOffset obx_fbb_prepare_bytes(struct OBX_fbb* _Nonnull self, const void* _Nonnull bytes, size_t size);
+
+/// Like obx_fbb_prepare_bytes(), but stores large byte vectors (see OBX_FBB_COMPRESSION_MIN_SIZE) compressed if that
+/// saves at least 1/8 of their size. Read the property using obx_fbr_read_bytes_compressed() to decompress them.
+/// Values starting like a compressed payload are always compressed, so they can't be taken for (corrupt) ones.
+/// Note: queries and indexes see the compressed bytes, so only use this for properties that are not queried.
+OBXDataOffset obx_fbb_prepare_bytes_compressed(struct OBX_fbb* _Nonnull self, const void* _Nonnull bytes, size_t size);
+
+/// Like obx_fbb_prepare_string_n(), but stores large strings compressed; see obx_fbb_prepare_bytes_compressed().
+OBXDataOffset obx_fbb_prepare_string_compressed(struct OBX_fbb* _Nonnull self, const char* _Nonnull string,
+                                                size_t length);
+
+/// Get the process-wide statistics of compressed strings and byte vectors.
+void obx_compression_stats(struct OBX_compression_stats* _Nonnull outStats);
+
+/// Prepare an int16 vector, e.g. for short and char vector properties.
+OBXDataOffset obx_fbb_prepare_shorts(struct OBX_fbb* _Nonnull self, const void* _Nonnull shorts, size_t size);
 OBXDataOffset obx_fbb_prepare_ints(struct OBX_fbb* _Nonnull self, const void* _Nonnull ints, size_t size);
 OBXDataOffset obx_fbb_prepare_longs(struct OBX_fbb* _Nonnull self, const void* _Nonnull longs, size_t size);
 
 OBXDataOffset obx_fbb_prepare_floats(struct OBX_fbb* _Nonnull self, const void* _Nonnull floats, size_t size);
+OBXDataOffset obx_fbb_prepare_doubles(struct OBX_fbb* _Nonnull self, const void* _Nonnull doubles, size_t size);
+
+/// Like obx_fbb_prepare_floats(), but places the floats at the given alignment, e.g. for aligned SIMD loads.
+/// The alignment is relative to the start of the finished FlatBuffer, so it applies in memory if the FlatBuffer's
+/// bytes are aligned at least as much; check this when reading via obx_fbr_read_floats_aligned().
+/// Note: this raises the alignment of the whole FlatBuffer, whose size is then padded by up to alignment - 1 bytes.
+/// @param alignment a power of two up to 256, e.g. 16, 32 or 64 (the size of SIMD registers or a cache line).
+/// @return 0 (the property is skipped) if the alignment is invalid.
+OBXDataOffset obx_fbb_prepare_floats_aligned(struct OBX_fbb* _Nonnull self, const void* _Nonnull floats, size_t size,
+                                             size_t alignment);
+
+/// Like obx_fbb_prepare_longs(), but places the longs at the given alignment; see obx_fbb_prepare_floats_aligned().
+OBXDataOffset obx_fbb_prepare_longs_aligned(struct OBX_fbb* _Nonnull self, const void* _Nonnull longs, size_t size,
+                                            size_t alignment);
 
 OBXDataOffset obx_fbb_prepare_strings(struct OBX_fbb* _Nonnull self, const char* _Nonnull const * _Nonnull strings, size_t size);
 
+/// Prepare a string vector from one concatenated UTF-8 blob; the strings do not have to be zero-terminated.
+/// @param blob all strings back to back; may be any non-NULL pointer if all strings are empty.
+/// @param lengths the byte length of each string within the blob, in order; count entries.
+OBXDataOffset obx_fbb_prepare_strings_blob(struct OBX_fbb* _Nonnull self, const char* _Nonnull blob,
+                                           const size_t* _Nonnull lengths, size_t count);
+
 #pragma mark - Reading
 
 /// Obtains a Flatbuffer root pointer for use with the other obx_fbr calls.
@@ -159,11 +332,31 @@ bool obx_fbr_read_double(const struct OBX_fbr* _Nonnull self, uint16_t propertyO
 /// @return a pointer to an internal buffer holding the string read, or NULL if it was a NULL value. Do not free the returned string, copy it to keep it around.
 const char * _Nullable obx_fbr_read_string(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset);
 
+/// Like obx_fbr_read_string(), but also provides the string's length (in bytes, without the terminating zero) as
+/// stored in the FlatBuffer, so there's no need to scan the string for it.
+/// @param outLength set to the length of the string; unchanged on NULL value.
+const char * _Nullable obx_fbr_read_string_n(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                             size_t* _Nonnull outLength);
+
 /// @param self the OBX_fbr from which you want to read.
 /// @param propertyOffset the offset of the offset to the actual data.
 /// @param outBytes This struct is set to the pointer and size of an internal buffer holding the bytes read. Do not free the buffer, copy it to keep it around.
 /// @return false on NULL value, true if result was set to a value.
 bool obx_fbr_read_bytes(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, OBX_bytes* _Nonnull outBytes);
+
+/// Like obx_fbr_read_string_n(), for string properties prepared using obx_fbb_prepare_string_compressed(): a compressed
+/// string is decompressed into a buffer of the calling thread, which is only valid until the next compressed string or
+/// byte vector is read on that thread. Strings stored uncompressed (e.g. small ones) are returned as they are.
+/// @returns OBX_SUCCESS if the outputs were set, OBX_NOT_FOUND on NULL value, OBX_ERROR_FILE_CORRUPT if the string is
+///          compressed but cannot be decompressed (e.g. its checksum does not match), or OBX_ERROR_STD_BAD_ALLOC.
+obx_err obx_fbr_read_string_compressed(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                       const char* _Nullable * _Nonnull outString, size_t* _Nonnull outLength);
+
+/// Like obx_fbr_read_bytes(), for byte vector properties prepared using obx_fbb_prepare_bytes_compressed(); compressed
+/// bytes are decompressed like strings, with the same results as obx_fbr_read_string_compressed().
+obx_err obx_fbr_read_bytes_compressed(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                      OBX_bytes* _Nonnull outBytes);
+bool obx_fbr_read_shorts(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, OBX_int16_array* _Nonnull outShorts);
 bool obx_fbr_read_ints(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, OBX_int32_array* _Nonnull outInts);
 bool obx_fbr_read_longs(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, OBX_int64_array* _Nonnull outLongs);
 
@@ -173,6 +366,19 @@ bool obx_fbr_read_longs(const struct OBX_fbr* _Nonnull self, uint16_t propertyOf
 /// @return false on NULL value, true if result was set to a value.
 bool obx_fbr_read_floats(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, OBX_float_array* _Nonnull outFloats);
 
+/// Fast path of obx_fbr_read_floats() for SIMD code: only succeeds if the floats are aligned in memory to the given
+/// alignment (see obx_fbb_prepare_floats_aligned()), so they can be used with aligned loads without copying them.
+/// @param alignment a power of two up to 256; other values are rejected by returning false.
+/// @return false on NULL value or if the floats are not aligned; use obx_fbr_read_floats() and copy them then.
+bool obx_fbr_read_floats_aligned(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, size_t alignment,
+                                 OBX_float_array* _Nonnull outFloats);
+
+/// @param self the OBX_fbr from which you want to read.
+/// @param propertyOffset the offset of the offset to the actual data.
+/// @param outDoubles This struct is set to the pointer and size of an internal buffer holding the doubles read. Do not free the buffer, copy it to keep it around.
+/// @return false on NULL value, true if result was set to a value.
+bool obx_fbr_read_doubles(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, OBX_double_array* _Nonnull outDoubles);
+
 /// @param self the OBX_fbr from which you want to read.
 /// @param propertyOffset the offset of the offset to the actual data.
 /// @param outInts This struct is set to the pointer and size of an internal buffer holding the ints read. Do not free the buffer, copy it to keep it around.
@@ -185,6 +391,18 @@ bool obx_fbr_read_ints(const struct OBX_fbr* _Nonnull self, uint16_t propertyOff
 /// @return false on NULL value, true if result was set to a value.
 bool obx_fbr_read_longs(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, OBX_int64_array* _Nonnull outLongs);
 
+/// Like obx_fbr_read_floats_aligned(), but for longs.
+bool obx_fbr_read_longs_aligned(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, size_t alignment,
+                                OBX_int64_array* _Nonnull outLongs);
+
+/// Read all given scalar properties into the given row struct with a single call, resolving the vtable only once.
+/// @param fields the layout, one entry per scalar property (see OBX_row_field).
+/// @param row the packed struct to write the values to at the offsets given by the layout; NULL values are set to 0.
+/// @param outPresence optional bitmap with one bit per layout entry (LSB first); a bit is set if the value is present
+///        and cleared on NULL. Must have room for (count + 7) / 8 bytes. Pass NULL if you're not interested in NULLs.
+void obx_fbr_read_row(const struct OBX_fbr* _Nonnull self, const struct OBX_row_field* _Nonnull fields, size_t count,
+                      void* _Nonnull row, uint8_t* _Nullable outPresence);
+
 /// Similar to OBX_string_array(_internal): we need an accessible vector to manage the memory for the string pointers.
 struct OBX_flat_strings {
     /// Nullable pointer to an array of non-null C string pointers.
@@ -200,6 +418,191 @@ struct OBX_flat_strings* _Nullable obx_fbr_read_strings(const struct OBX_fbr* _N
 /// To free the vector resources of the struct returned by ``obx_fbr_read_strings(self, propertyOffset)``.
 void obx_flat_strings_free(struct OBX_flat_strings* _Nullable strings);
 
+/// Allocation-free alternative to obx_fbr_read_strings(): get the number of strings, then each string by its index
+/// using obx_fbr_read_strings_at().
+/// @param outCount set to the number of strings in the vector; unchanged on NULL value.
+/// @return false on NULL value, true if outCount was set.
+bool obx_fbr_read_strings_count(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                size_t* _Nonnull outCount);
+
+/// Get a string of a string vector by its index, pointing directly into the FlatBuffer data; nothing is allocated.
+/// @param index must be lower than the count given by obx_fbr_read_strings_count().
+/// @param outString set to the zero-terminated string; do not free it, copy it to keep it around.
+/// @param outLength set to the length of the string in bytes (without the terminating zero).
+/// @return false on NULL value or if the index is out of bounds.
+bool obx_fbr_read_strings_at(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, size_t index,
+                             const char* _Nullable * _Nonnull outString, size_t* _Nonnull outLength);
+
+/// Position of a string within a string vector, relative to the base given by obx_fbr_read_string_spans().
+struct OBX_string_span {
+    uint32_t offset;
+    /// In bytes, without the terminating zero.
+    uint32_t length;
+};
+
+/// Get the positions of all strings of a string vector with a single call, e.g. to create all strings from their
+/// UTF-8 bytes without looking up each one; the strings point directly into the FlatBuffer data.
+/// @param outSpans receives one span per string; capacity must be at least obx_fbr_read_strings_count().
+/// @param outBase set to the address the span offsets are relative to.
+/// Strings are not validated; e.g. Swift's String(decoding:as:) validates (and repairs) UTF-8 when creating a string.
+/// @return false on NULL value or if the capacity is too small.
+bool obx_fbr_read_string_spans(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                               struct OBX_string_span* _Nullable outSpans, size_t capacity,
+                               const char* _Nullable * _Nonnull outBase);
+
+#pragma mark - Patching
+
+/* Patching updates scalar values of a stored object in place, without collecting the whole object again:
+   copy the object into the builder using obx_fbb_patch_start(), set values using the obx_fbr_patch functions, and put
+   the result given by obx_fbb_patch_get(). Only values present in the stored object can be patched; if a patch
+   function returns false, the object has to be collected again (see obx_fbb_is_collected()). */
+
+/// Copy the given object (e.g. from obx_cursor_get()) into the builder's scratch buffer to patch it.
+/// Independent of collecting; the scratch buffer is kept for the next patch.
+/// @return the mutable root of the copy, valid until the next call to obx_fbb_patch_start(); NULL if out of memory.
+struct OBX_fbr* _Nullable obx_fbb_patch_start(struct OBX_fbb* _Nonnull self, const void* _Nonnull bytes, size_t size);
+
+/// Get the patched object; references the builder's scratch buffer, which is valid until the next patch.
+void obx_fbb_patch_get(struct OBX_fbb* _Nonnull self, OBX_bytes* _Nonnull outBytes);
+
+/// Whether a value was collected for the given property of the object currently being collected.
+bool obx_fbb_is_collected(struct OBX_fbb* _Nonnull self, uint16_t propertyOffset);
+
+/* Set the value of a present field, like FlatBuffers' SetField(); the type must match the property's type.
+   Return false without changing anything if the field is absent (NULL, or added to the schema after writing). */
+bool obx_fbr_patch_bool(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, bool value);
+bool obx_fbr_patch_int8(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, int8_t value);
+bool obx_fbr_patch_int16(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, int16_t value);
+bool obx_fbr_patch_int32(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, int32_t value);
+bool obx_fbr_patch_int64(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, int64_t value);
+bool obx_fbr_patch_uint8(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, uint8_t value);
+bool obx_fbr_patch_uint16(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, uint16_t value);
+bool obx_fbr_patch_uint32(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, uint32_t value);
+bool obx_fbr_patch_uint64(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, uint64_t value);
+bool obx_fbr_patch_float(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, float value);
+bool obx_fbr_patch_double(struct OBX_fbr* _Nonnull self, uint16_t propertyOffset, double value);
+
+#pragma mark - FlexBuffers
+
+/* Building a FlexBuffer value for a flex property: add values (and keys) using the obx_fbb_flex functions, then call
+   obx_fbb_flex_finish() to prepare the FlexBuffer as a byte vector. Like other prepare calls, this must happen before
+   collecting scalars. Vectors and maps are started, filled and ended; map entries are added as a key followed by its
+   value. The root may be any value, but must be the only one. */
+
+void obx_fbb_flex_null(struct OBX_fbb* _Nonnull self);
+void obx_fbb_flex_bool(struct OBX_fbb* _Nonnull self, bool value);
+void obx_fbb_flex_int(struct OBX_fbb* _Nonnull self, int64_t value);
+void obx_fbb_flex_uint(struct OBX_fbb* _Nonnull self, uint64_t value);
+void obx_fbb_flex_double(struct OBX_fbb* _Nonnull self, double value);
+/// @param string UTF-8 string of the given length in bytes; does not have to be zero-terminated.
+void obx_fbb_flex_string(struct OBX_fbb* _Nonnull self, const char* _Nonnull string, size_t length);
+void obx_fbb_flex_blob(struct OBX_fbb* _Nonnull self, const void* _Nonnull data, size_t size);
+/// Adds the key of the following map value; keys must not contain zero bytes.
+void obx_fbb_flex_key(struct OBX_fbb* _Nonnull self, const char* _Nonnull key, size_t length);
+
+void obx_fbb_flex_vector_start(struct OBX_fbb* _Nonnull self);
+void obx_fbb_flex_vector_end(struct OBX_fbb* _Nonnull self);
+void obx_fbb_flex_map_start(struct OBX_fbb* _Nonnull self);
+void obx_fbb_flex_map_end(struct OBX_fbb* _Nonnull self);
+
+/// Finish the FlexBuffer built by the preceding obx_fbb_flex calls and prepare it as a byte vector for collecting.
+/// The FlexBuffer builder is reset (keeping its memory) for the next flex property.
+OBXDataOffset obx_fbb_flex_finish(struct OBX_fbb* _Nonnull self);
+
+/// Simplified type of a FlexBuffers value; e.g. typed and untyped vectors are both OBXFlexType_Vector.
+typedef enum {
+    OBXFlexType_Null = 0,
+    OBXFlexType_Bool = 1,
+    OBXFlexType_Int = 2,
+    OBXFlexType_UInt = 3,
+    OBXFlexType_Float = 4,
+    OBXFlexType_String = 5,
+    OBXFlexType_Key = 6,
+    OBXFlexType_Blob = 7,
+    OBXFlexType_Vector = 8,
+    OBXFlexType_Map = 9,
+} OBXFlexType;
+
+/// Lazy reference to a value inside a FlexBuffer, pointing directly into the data; nothing is decoded or allocated
+/// until a value is accessed. Valid as long as the underlying data is, e.g. for the duration of a read transaction.
+struct OBX_flex_ref {
+    const void* _Nullable data;  ///< Only NULL for a default initialized reference that was not yet set
+    uint8_t parent_width;
+    uint8_t byte_width;
+    uint8_t type;  ///< Internal FlexBuffers type; use obx_flex_type()
+};
+
+/// Get the root value of a flex property.
+/// @return false on NULL value or if the data is not a valid FlexBuffer.
+bool obx_fbr_read_flex(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                       struct OBX_flex_ref* _Nonnull outRef);
+
+/// Get the root value of the given FlexBuffer data.
+/// @return false if the data is not a valid FlexBuffer.
+bool obx_flex_root(const void* _Nonnull data, size_t size, struct OBX_flex_ref* _Nonnull outRef);
+
+OBXFlexType obx_flex_type(const struct OBX_flex_ref* _Nonnull ref);
+
+/* Numeric values are converted to the requested type; other types give 0 (or false). */
+bool obx_flex_as_bool(const struct OBX_flex_ref* _Nonnull ref);
+int64_t obx_flex_as_int(const struct OBX_flex_ref* _Nonnull ref);
+uint64_t obx_flex_as_uint(const struct OBX_flex_ref* _Nonnull ref);
+double obx_flex_as_double(const struct OBX_flex_ref* _Nonnull ref);
+
+/// @param outLength set to the length of the string in bytes (without the terminating zero).
+/// @return the zero-terminated string (or key), or NULL if the value is not a string. Do not free it.
+const char* _Nullable obx_flex_as_string(const struct OBX_flex_ref* _Nonnull ref, size_t* _Nonnull outLength);
+
+/// @return false if the value is not a blob (or string); otherwise outBytes references the bytes. Do not free them.
+bool obx_flex_as_blob(const struct OBX_flex_ref* _Nonnull ref, OBX_bytes* _Nonnull outBytes);
+
+/// @return the number of elements of a vector or map (entries); 0 for other types.
+size_t obx_flex_count(const struct OBX_flex_ref* _Nonnull ref);
+
+/// Get an element of a vector, or the value of a map entry, by its index.
+/// @return false if the value is not a vector or map, or if the index is out of bounds.
+bool obx_flex_at(const struct OBX_flex_ref* _Nonnull ref, size_t index, struct OBX_flex_ref* _Nonnull outRef);
+
+/// Get the key of a map entry by its index; entries are sorted by their keys.
+/// @param outKey set to the zero-terminated key; do not free it.
+/// @return false if the value is not a map, or if the index is out of bounds.
+bool obx_flex_key_at(const struct OBX_flex_ref* _Nonnull ref, size_t index,
+                     const char* _Nullable * _Nonnull outKey, size_t* _Nonnull outLength);
+
+/// Look up a map value by its key using a binary search; the key does not have to be zero-terminated.
+/// @return false if the value is not a map or it does not contain the key.
+bool obx_flex_lookup(const struct OBX_flex_ref* _Nonnull ref, const char* _Nonnull key, size_t length,
+                     struct OBX_flex_ref* _Nonnull outRef);
+
+#pragma mark - Quantized Vectors
+
+/// How a float vector is stored; quantized encodings trade precision for size (e.g. for embeddings).
+/// Note: only Float32 vectors can be indexed by HNSW (see OBXHnswDistanceType); quantized vectors are stored only.
+typedef enum {
+    /// 4 bytes per element; the same as obx_fbb_prepare_floats().
+    OBXVectorEncoding_Float32 = 0,
+    /// IEEE half precision, 2 bytes per element (stored as an uint16 vector).
+    OBXVectorEncoding_Float16 = 1,
+    /// 1 byte per element, scaled by the vector's largest absolute value (stored as a byte vector: a float scale
+    /// followed by the int8 values). Infinities are clamped to the largest finite magnitude, NaN is stored as 0.
+    OBXVectorEncoding_Int8 = 2,
+} OBXVectorEncoding;
+
+/// Prepare a float vector, which is quantized using the given encoding (uses SIMD instructions if available).
+OBXDataOffset obx_fbb_prepare_floats_encoded(struct OBX_fbb* _Nonnull self, const float* _Nonnull floats,
+                                             size_t count, OBXVectorEncoding encoding);
+
+/// Get the number of floats of a vector prepared by obx_fbb_prepare_floats_encoded() with the given encoding.
+/// @return false on NULL value.
+bool obx_fbr_read_floats_count(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                               OBXVectorEncoding encoding, size_t* _Nonnull outCount);
+
+/// Reads a vector prepared by obx_fbb_prepare_floats_encoded() with the given encoding and converts it back to floats.
+/// @param outFloats receives up to capacity floats; see obx_fbr_read_floats_count().
+/// @return the number of floats written, i.e. 0 on NULL value.
+size_t obx_fbr_read_floats_decoded(const struct OBX_fbr* _Nonnull self, uint16_t propertyOffset,
+                                   OBXVectorEncoding encoding, float* _Nonnull outFloats, size_t capacity);
+
 #if __cplusplus
 }
 #endif
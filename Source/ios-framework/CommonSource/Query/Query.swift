@@ -165,6 +165,38 @@ public class Query<E: EntityInspectable & __EntityRelatable>: CustomDebugStringC
         return result
     }
 
+    /// Visits the objects matching the query without creating objects, calling the given closure with a reader for
+    /// the data of each object; e.g. to read vector properties as `VectorView` without copying them.
+    /// The reader (and views read from it) are only valid during the call of the closure.
+    /// - Parameter visitor: Return true to keep going, false to abort. Exceptions thrown by the closure are re-thrown.
+    public func visitReaders(offset: Int = 0, limit: Int = 0, _ visitor: (FlatBufferReader) throws -> Bool) throws {
+        try store.runInReadOnlyTransaction {
+            try withoutActuallyEscaping(visitor) { callback in
+                var reader = FlatBufferReader()
+                var userError: Swift.Error?
+                let context = CDataVisitorContext({ (data: UnsafeRawPointer?, _) -> Bool in
+                    guard let safePtr = data else {
+                        return false
+                    }
+                    reader.setCurrentlyReadTableBytes(safePtr)
+                    do {
+                        return try callback(reader)
+                    } catch {
+                        userError = error
+                        return false
+                    }
+                })
+
+                try checkCResult(obx_query_offset_limit(cQuery, offset, limit))
+                let error = obx_query_visit(cQuery, CDataVisitor, Unmanaged.passUnretained(context).toOpaque())
+                if let userError = userError {
+                    throw userError
+                }
+                try check(error: error)
+            }
+        }
+    }
+
     /// Find all object IDs matching the query between the given offset and limit.
     ///
     /// - Parameters:
@@ -56,9 +56,10 @@ where Target == Target.EntityBindingType.EntityType {
             switch self {
             case .none:
                 return nil
-            case .unstored:
-//                fatalError()
-                return nil
+            case .unstored(entity: let entity):
+                // Set once the target was put (e.g. earlier in the same bulk put), so it is not put again
+                let entityId = Target.entityBinding.entityId(of: entity)
+                return entityId != 0 ? EntityId<Target>(entityId) : nil
             case .lazy(id: let entityId),
                  .stored(id: let entityId, entity: _),
                  .unresolvable(id: let entityId):
@@ -103,6 +103,27 @@ class AsyncBoxTests: XCTestCase {
         XCTAssertEqual(readAmy?.name, "Amy Winehouse")
     }
     
+    func testAsyncMultiPutReservesIdRanges() throws {
+        let box: Box<TestPerson> = store.box(for: TestPerson.self)
+        let existing = TestPerson(name: "Existing", age: 1)
+        try box.put(existing)
+
+        // More new objects than a single range can hold
+        let count = ReservedIds.maxRangeSize + 1_000
+        var persons = (0 ..< count).map { TestPerson(name: "Person \($0)", age: $0) }
+        persons.insert(existing, at: 42)
+        let ids = try box.async.put(persons)
+        store.awaitAsyncSubmitted()
+
+        XCTAssertEqual(ids[42], existing.id)
+        var newIds = ids.map { $0.value }
+        newIds.remove(at: 42)
+        XCTAssertEqual(newIds, newIds.sorted())
+        XCTAssertEqual(Set(newIds).count, count)
+        XCTAssertEqual(try box.count(), count + 1)
+        XCTAssertEqual(try box.get(ids.last!)?.name, "Person \(count - 1)")
+    }
+    
     func testAsyncRemove() throws {
         let box: Box<TestPerson> = store.box(for: TestPerson.self)
         
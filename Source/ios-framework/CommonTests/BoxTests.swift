@@ -102,6 +102,43 @@ class BoxTests: XCTestCase {
         XCTAssertEqual(entitiesById[person3Id]?.name, "Baz")
     }
 
+    func testGetManyInIdOrderKeepsGivenOrder() throws {
+        let box: Box<TestPerson> = store.box(for: TestPerson.self)
+        let ids = try box.putAndReturnIDs((0 ..< 100).map { TestPerson(name: "Person \($0)", age: $0) })
+
+        // Unordered, with duplicates and missing IDs; more than read one by one
+        var requested = ids.shuffled()
+        requested.insert(ids[7], at: 3)
+        requested.insert(EntityId<TestPerson>(1_000), at: 10)
+        XCTAssertGreaterThanOrEqual(requested.count, Box<TestPerson>.sortedGetMinimumCount)
+
+        let objects = try box.get(requested)
+        XCTAssertEqual(objects.count, requested.count - 1)
+        XCTAssertEqual(objects.map { $0.id }, requested.filter { $0.value != 1_000 })
+        XCTAssertEqual(objects[3].name, "Person 7")
+
+        let entitiesById = try box.getAsDictionary(requested)
+        XCTAssertEqual(entitiesById.count, ids.count)
+        XCTAssertEqual(entitiesById[ids[42]]?.age, 42)
+        XCTAssertNil(entitiesById[EntityId<TestPerson>(1_000)])
+    }
+
+    func testReadAllDecodedInParallelKeepsOrder() throws {
+        let box: Box<TestPerson> = store.box(for: TestPerson.self)
+        let count = Box<TestPerson>.parallelReadChunkSize * 4 + 17
+        try box.put((0 ..< count).map { TestPerson(name: "Person \($0)", age: $0) })
+        let expected = try box.all()
+
+        box.decodesReadsInParallel = true
+        let persons = try box.all()
+        XCTAssertEqual(persons.map { $0.id }, expected.map { $0.id })
+        XCTAssertEqual(persons.map { $0.name }, expected.map { $0.name })
+        XCTAssertEqual(try box.allContiguous().map { $0.age }, expected.map { $0.age })
+
+        let query = try box.query { TestPerson.age >= 17 }.build()
+        XCTAssertEqual(try query.find().map { $0.age }, Array(17 ..< count))
+    }
+
     func testPutGet_AllPropertyTypes() throws {
         let box: Box<AllTypesEntity> = store.box(for: AllTypesEntity.self)
 
@@ -212,6 +249,19 @@ class BoxTests: XCTestCase {
         XCTAssertEqual(secondPersonId, firstPersonId)
     }
 
+    func testPutManyWithRelationToEarlierNewObjectPutsItOnce() throws {
+        let box = store.box(for: TestReferral.self)
+        let referrer = TestReferral(name: "Referrer")
+        let referred = TestReferral(name: "Referred")
+        referred.referrer.target = referrer
+        try box.put([referrer, referred])
+
+        XCTAssertEqual(try box.count(), 2)
+        XCTAssertNotEqual(referrer.id, 0)
+        XCTAssertEqual(referred.referrer.targetId, referrer.id)
+        XCTAssertEqual(try box.get(referred.id)?.referrer.target?.name, "Referrer")
+    }
+
     func testNestedWriteTransactionRollback() throws {
         let box: Box<TestPerson> = store.box(for: TestPerson.self)
 
@@ -372,6 +422,70 @@ class BoxTests: XCTestCase {
         XCTAssertFalse(try box.contains([persons[6].id, persons[2].id, persons[5].id, persons[8].id]))
     }
 
+    func testContainsAndRemoveManyUnsortedIds() throws {
+        let box: Box<TestPerson> = store.box(for: TestPerson.self)
+        let ids = try box.putAndReturnIDs((0 ..< 100).map { TestPerson(name: "Person \($0)", age: $0) })
+
+        XCTAssert(try box.contains([EntityId<TestPerson>]()))
+        XCTAssert(try box.contains(ids.shuffled()))
+        XCTAssertFalse(try box.contains([ids[3], EntityId<TestPerson>(0)]))
+        XCTAssertFalse(try box.contains([ids[3], EntityId<TestPerson>(1_000)]))
+
+        // Unordered, with a duplicate, a missing and a not yet put (zero) ID
+        var toRemove = Array(ids[10 ..< 50]).shuffled()
+        toRemove.append(contentsOf: [ids[20], EntityId<TestPerson>(1_000), EntityId<TestPerson>(0)])
+        XCTAssertEqual(try box.remove(toRemove), 40)
+        XCTAssertEqual(try box.count(), 60)
+        XCTAssertFalse(try box.contains(ids[20]))
+        XCTAssert(try box.contains(Array(ids[50...]) + Array(ids[..<10])))
+
+        var persons = try box.get(Array(ids[50 ..< 60]))
+        persons.append(TestPerson(name: "New", age: 0))
+        XCTAssertEqual(try box.remove(persons.reversed()), 10)
+        XCTAssertEqual(try box.remove([Id]()), 0)
+        XCTAssertEqual(try box.count(), 50)
+    }
+
+    /// Compares looking up and removing IDs one by one with a cursor to the bulk calls used by Box.
+    /// Takes a while and is thus only run if the environment variable OBX_BENCHMARK is set to "true".
+    func testBenchmarkContainsAndRemoveMany() throws {
+        guard ProcessInfo.processInfo.environment["OBX_BENCHMARK"] == "true" else { return }
+        let benchStore = StoreHelper.tempStore(model: createTestModel(), maxDbSizeInKByte: 2 * 1024 * 1024)
+        defer { try? benchStore.closeAndDeleteAllFiles() }
+        let box: Box<TestPerson> = benchStore.box(for: TestPerson.self)
+
+        func seconds(_ block: () throws -> Void) rethrows -> Double {
+            let start = DispatchTime.now().uptimeNanoseconds
+            try block()
+            return Double(DispatchTime.now().uptimeNanoseconds - start) / 1_000_000_000
+        }
+
+        for count in [1_000, 100_000, 1_000_000] {
+            let persons = (0 ..< count).map { TestPerson(name: "Person \($0)", age: $0) }
+            var ids = try box.putAndReturnIDs(persons).shuffled()
+
+            let containsLooped = try seconds {
+                try benchStore.obx_runInTransaction(writable: false, { swiftTx in
+                    let cursor = try Cursor<TestPerson>(transaction: swiftTx)
+                    for id in ids where try !cursor.contains(id.value) { XCTFail("Missing \(id)") }
+                })
+            }
+            let containsBulk = try seconds { XCTAssert(try box.contains(ids)) }
+
+            let removeLooped = try seconds {
+                try benchStore.obx_runInTransaction(writable: true, { swiftTx in
+                    let cursor = try Cursor<TestPerson>(transaction: swiftTx)
+                    for id in ids { XCTAssert(try cursor.remove(id.value)) }
+                })
+            }
+            ids = try box.putAndReturnIDs(persons.map { TestPerson(name: $0.name, age: $0.age) }).shuffled()
+            let removeBulk = try seconds { XCTAssertEqual(try box.remove(ids), UInt64(count)) }
+
+            print(String(format: "%7d IDs: contains looped %.3fs, bulk %.3fs; remove looped %.3fs, bulk %.3fs",
+                         count, containsLooped, containsBulk, removeLooped, removeBulk))
+        }
+    }
+
     // MARK: - visiting
 
     func testForEach() throws {
@@ -803,6 +917,105 @@ class BoxTests: XCTestCase {
         XCTAssertNoThrow(try box.put(person2, mode: .update))
     }
 
+    func testUpdatePatchesScalars() throws {
+        let box: Box<AllTypesEntity> = store.box(for: AllTypesEntity.self)
+        let entity = AllTypesEntity.create(integer: 1, double: 1.5, string: "unchanged")
+        entity.date = Date(timeIntervalSince1970: 1_000)
+        let id = try box.put(entity)
+
+        XCTAssertTrue(try box.update(id: id) { patch in
+            patch.set(AllTypesEntity.integer, to: 2)
+            patch.set(AllTypesEntity.long, to: Int.max)
+            patch.set(AllTypesEntity.boolean, to: true)
+            patch.set(AllTypesEntity.unsigned, to: UInt32.max)
+            patch.set(AllTypesEntity.date, to: Date(timeIntervalSince1970: 2_000))
+        })
+
+        let updated = try XCTUnwrap(box.get(id))
+        XCTAssertEqual(updated.integer, 2)
+        XCTAssertEqual(updated.aLong, Int.max)
+        XCTAssertTrue(updated.boolean)
+        XCTAssertEqual(updated.unsigned, UInt32.max)
+        XCTAssertEqual(updated.aDouble, 1.5)
+        XCTAssertEqual(updated.date, Date(timeIntervalSince1970: 2_000))
+        XCTAssertEqual(updated.string, "unchanged")
+        XCTAssertEqual(try box.count(), 1)
+
+        XCTAssertFalse(try box.update(id: EntityId<AllTypesEntity>(id.value + 1)) { patch in
+            patch.set(AllTypesEntity.integer, to: 3)
+        })
+        XCTAssertEqual(try box.count(), 1)
+    }
+
+    func testUpdateRebuildsObjectForAbsentProperty() throws {
+        let box: Box<AllTypesEntity> = store.box(for: AllTypesEntity.self)
+        let entity = AllTypesEntity.create(integer: 1, double: 1.5, string: "unchanged")
+        XCTAssertNil(entity.date)  // Not collected, thus absent in the stored object
+        let id = try box.put(entity)
+
+        try box.update(id: id) { patch in
+            patch.set(AllTypesEntity.date, to: Date(timeIntervalSince1970: 3_000))
+            patch.set(AllTypesEntity.integer, to: 4)
+        }
+
+        let updated = try XCTUnwrap(box.get(id))
+        XCTAssertEqual(updated.date, Date(timeIntervalSince1970: 3_000))
+        XCTAssertEqual(updated.integer, 4)
+        XCTAssertEqual(updated.aDouble, 1.5)
+        XCTAssertEqual(updated.string, "unchanged")
+    }
+
+    func testUpdateKnowsDateNanoProperties() {
+        // Patches check this to reject set(_:to:) for dateNano and setNanos(_:to:) for date properties
+        XCTAssertFalse(AllTypesEntity.entityInfo.isDateNano(propertyId: AllTypesEntity.date.propertyId))
+
+        let entityInfo = EntityInfo(name: "Dates", id: 42)
+        entityInfo.modelProperty(id: 2, type: .date)
+        entityInfo.modelProperty(id: 3, type: .dateNano)
+        XCTAssertFalse(entityInfo.isDateNano(propertyId: 2))
+        XCTAssertTrue(entityInfo.isDateNano(propertyId: 3))
+    }
+
+    func testSkipsUnchangedPuts() throws {
+        let box: Box<TestPerson> = store.box(for: TestPerson.self)
+        let person = TestPerson(name: "Unchanged", age: 42)
+        try box.put(person)
+        XCTAssertEqual(box.skippedPutCount, 0)
+
+        try box.put(person)
+        XCTAssertEqual(box.skippedPutCount, 0)  // Not enabled yet
+
+        box.skipsUnchangedPuts = true
+        try box.put(person)
+        XCTAssertEqual(box.skippedPutCount, 1)
+
+        person.age = 43
+        try box.put(person)
+        XCTAssertEqual(box.skippedPutCount, 1)
+        XCTAssertEqual(try box.get(person.id)?.age, 43)
+
+        let others = [TestPerson(name: "A", age: 1), TestPerson(name: "B", age: 2)]
+        try box.put(others)  // New objects are never skipped
+        XCTAssertEqual(box.skippedPutCount, 1)
+        others[1].age = 3
+        try box.put(others + [person])
+        XCTAssertEqual(box.skippedPutCount, 3)
+        XCTAssertEqual(try box.get(others[1].id)?.age, 3)
+        XCTAssertEqual(try box.count(), 3)
+
+        try box.put(person, mode: .update)
+        XCTAssertEqual(box.skippedPutCount, 4)
+
+        // The same object twice: the second copy equals the stored object, but not the first copy put before it
+        guard let changedCopy = try box.get(person.id), let storedCopy = try box.get(person.id) else {
+            XCTFail("Expected to find person"); return
+        }
+        changedCopy.age = 44
+        try box.put([changedCopy, storedCopy])
+        XCTAssertEqual(box.skippedPutCount, 4)
+        XCTAssertEqual(try box.get(person.id)?.age, 43)
+    }
+
     func testUniqueViolated() throws {
         let box: Box<UniqueEntity> = store.box(for: UniqueEntity.self)
         try box.put(UniqueEntity(name: "same"))
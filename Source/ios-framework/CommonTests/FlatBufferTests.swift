@@ -0,0 +1,1053 @@
+//
+// Copyright © 2026 ObjectBox Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+import XCTest
+@testable import ObjectBox
+
+/// Tests for the FlatBuffers bridge (obx_fbb/obx_fbr) and its Swift wrappers FlatBufferBuilder and FlatBufferReader.
+class FlatBufferTests: XCTestCase {
+
+    var store: Store!
+
+    override func setUp() {
+        super.setUp()
+        store = StoreHelper.tempStore(model: createTestModel())
+    }
+
+    override func tearDown() {
+        // swiftlint:disable:next force_try
+        try! store?.closeAndDeleteAllFiles()
+        store = nil
+        super.tearDown()
+    }
+
+    func testBuilderKeepsBufferAcrossClear() throws {
+        let flatBuffer = FlatBufferBuilder()
+        let bytes = [UInt8](repeating: 42, count: 20_000)
+
+        for _ in 0..<3 {
+            flatBuffer.isCollecting = true
+            let offset = flatBuffer.prepare(bytes: bytes)
+            flatBuffer.collect(dataOffset: offset, at: 4)
+            flatBuffer.ensureStarted()
+            _ = try flatBuffer.finish()
+            flatBuffer.clear()
+            flatBuffer.isCollecting = false
+        }
+
+        let stats = flatBuffer.stats
+        XCTAssertGreaterThanOrEqual(stats.capacity, 20_000)
+        XCTAssertGreaterThanOrEqual(stats.in_use_bytes, stats.capacity)
+        XCTAssertEqual(stats.flex_capacity, 0)
+        XCTAssertGreaterThan(stats.grow_events, 0)
+
+        // Same object again: the retained buffer must be used as is
+        flatBuffer.isCollecting = true
+        let offset = flatBuffer.prepare(bytes: bytes)
+        flatBuffer.collect(dataOffset: offset, at: 4)
+        flatBuffer.ensureStarted()
+        _ = try flatBuffer.finish()
+        flatBuffer.clear()
+        flatBuffer.isCollecting = false
+
+        XCTAssertEqual(flatBuffer.stats.heap_allocations, stats.heap_allocations)
+        XCTAssertEqual(flatBuffer.stats.grow_events, stats.grow_events)
+    }
+
+    func testSteadyStatePutsDoNotAllocate() throws {
+        let box = store.box(for: TestPerson.self)
+        try box.put(TestPerson(name: "Warm-up with a somewhat longer name", age: 1))
+
+        let flatBuffer = FlatBufferBuilder.dequeue()
+        let before = flatBuffer.stats
+        FlatBufferBuilder.return(flatBuffer)
+
+        for i in 0..<100 {
+            try box.put(TestPerson(name: "Person \(i)", age: i))
+        }
+
+        let flatBufferAfter = FlatBufferBuilder.dequeue()
+        let after = flatBufferAfter.stats
+        FlatBufferBuilder.return(flatBufferAfter)
+
+        XCTAssert(flatBuffer === flatBufferAfter)
+        XCTAssertEqual(after.heap_allocations, before.heap_allocations)
+        XCTAssertEqual(after.grow_events, before.grow_events)
+        XCTAssertEqual(try box.count(), 101)
+    }
+
+    func testBatchedPutSpanningSeveralBatches() throws {
+        let box = store.box(for: TestPerson.self)
+        let count = Box<TestPerson>.putBatchSize * 2 + 17
+        let persons = (0 ..< count).map { TestPerson(name: "Person \($0)", age: $0) }
+
+        let ids = try box.putAndReturnIDs(persons)
+        XCTAssertEqual(ids.count, count)
+        XCTAssertEqual(try box.count(), count)
+        for (index, person) in persons.enumerated() {
+            XCTAssertEqual(person.id, ids[index])
+        }
+
+        let read = try box.get(ids[count - 1])
+        XCTAssertEqual(read?.name, "Person \(count - 1)")
+        XCTAssertEqual(read?.age, count - 1)
+
+        // Builder is left clean for the next put
+        let flatBuffer = FlatBufferBuilder.dequeue()
+        XCTAssertEqual(flatBuffer.batchCount, 0)
+        XCTAssertFalse(flatBuffer.isCollecting)
+        FlatBufferBuilder.return(flatBuffer)
+    }
+
+    func testPutEncodedInParallel() throws {
+        let box = store.box(for: TestPerson.self)
+        box.encodesPutsInParallel = true
+        let existing = TestPerson(name: "Existing", age: 0)
+        try box.put(existing)
+        let count = Box<TestPerson>.parallelPutChunkSize * 4 + 17
+        var persons = (1 ..< count).map { TestPerson(name: "Person \($0)", age: $0) }
+        existing.name = "Updated"
+        persons.insert(existing, at: count / 2)
+
+        let ids = try box.putAndReturnIDs(persons)
+        XCTAssertEqual(try box.count(), count)
+        XCTAssertEqual(ids[count / 2], existing.id)
+        // New objects get consecutive IDs in the order of the collection
+        let newIds = ids.enumerated().filter { $0.offset != count / 2 }.map { $0.element.value }
+        XCTAssertEqual(newIds, Array(newIds[0] ..< newIds[0] + UInt64(count - 1)))
+        for (index, person) in persons.enumerated() {
+            XCTAssertEqual(person.id, ids[index])
+            XCTAssertEqual(try box.get(ids[index])?.name, person.name)
+        }
+    }
+
+    func testPutEncodedInParallelRejectsInvalidIdLikeSequentialPut() throws {
+        let box = store.box(for: TestPerson.self)
+        let count = Box<TestPerson>.parallelPutChunkSize * 4
+        func makePersons() -> [TestPerson] {
+            let persons = (0 ..< count).map { TestPerson(name: "Person \($0)", age: $0) }
+            persons[count / 2].id = 1_000_000  // Above the box's ID sequence
+            return persons
+        }
+        // The error case only; the message may mention the current ID sequence
+        func errorCase(_ error: Swift.Error) -> String {
+            return String(String(describing: error).prefix { $0 != "(" })
+        }
+
+        var sequentialError: Swift.Error?
+        XCTAssertThrowsError(try box.put(makePersons())) { sequentialError = $0 }
+        box.encodesPutsInParallel = true
+        XCTAssertThrowsError(try box.put(makePersons())) { error in
+            XCTAssertEqual(errorCase(error), sequentialError.map(errorCase))
+        }
+        XCTAssertEqual(try box.count(), 0)
+    }
+
+    func testPutEncodedInParallelPutsRepeatedNewObjectOnce() throws {
+        let box = store.box(for: TestPerson.self)
+        box.encodesPutsInParallel = true
+        let count = Box<TestPerson>.parallelPutChunkSize * 4
+        var persons = (0 ..< count).map { TestPerson(name: "Person \($0)", age: $0) }
+        persons.append(persons[10])
+
+        let ids = try box.putAndReturnIDs(persons)
+        XCTAssertEqual(try box.count(), count)
+        XCTAssertEqual(ids[count], ids[10])
+        XCTAssertEqual(persons[10].id, ids[10])
+    }
+
+    func testVTableCacheIsUsedForSameShapedObjects() throws {
+        let box = store.box(for: TestPerson.self)
+        // Tables are not padded to a fixed start, so each padding left by the name's length has its own vtable entry
+        for length in 0 ..< 8 {
+            try box.put(TestPerson(name: String(repeating: "w", count: length), age: length))
+        }
+
+        let flatBuffer = FlatBufferBuilder.dequeue()
+        let before = flatBuffer.stats
+        FlatBufferBuilder.return(flatBuffer)
+
+        for i in 0..<50 {
+            try box.put(TestPerson(name: String(repeating: "n", count: i), age: i))
+        }
+
+        let after = flatBuffer.stats
+        XCTAssertEqual(after.vtable_cache_hits - before.vtable_cache_hits, 50)
+        XCTAssertEqual(after.vtable_cache_misses, before.vtable_cache_misses)
+
+        let persons = try box.all()
+        XCTAssertEqual(persons.count, 58)
+        for person in persons {
+            XCTAssertEqual(person.name?.count, person.age)
+        }
+    }
+
+    private struct ScalarRow {
+        var id: UInt64
+        var aDouble: Double
+        var aFloat: Float
+        var integer: Int32
+        var short: Int16
+        var flag: Bool
+    }
+
+    private static let scalarRowLayout: FlatBufferRowLayout = {
+        var layout = FlatBufferRowLayout()
+        layout.add(\ScalarRow.id, propertyOffset: 4, type: .long)
+        layout.add(\ScalarRow.aDouble, propertyOffset: 6, type: .double)
+        layout.add(\ScalarRow.aFloat, propertyOffset: 8, type: .float)
+        layout.add(\ScalarRow.integer, propertyOffset: 10, type: .int)
+        layout.add(\ScalarRow.short, propertyOffset: 12, type: .short)
+        layout.add(\ScalarRow.flag, propertyOffset: 14, type: .bool)
+        return layout
+    }()
+
+    func testCollectRowMatchesCollectingEachProperty() throws {
+        let rows = [ScalarRow(id: 42, aDouble: 3.5, aFloat: -1.25, integer: -7, short: 300, flag: true),
+                    ScalarRow(id: 1, aDouble: -0.0, aFloat: -0.0, integer: 0, short: 0, flag: false)]
+        for row in rows {
+            let rowBuffer = FlatBufferBuilder()
+            rowBuffer.isCollecting = true
+            rowBuffer.collect(row: row, layout: FlatBufferTests.scalarRowLayout)
+            let rowBytes = try rowBuffer.finish()
+
+            let singleBuffer = FlatBufferBuilder()
+            singleBuffer.isCollecting = true
+            singleBuffer.collect(row.id, at: 4)
+            singleBuffer.collect(row.aDouble, at: 6)
+            singleBuffer.collect(row.aFloat, at: 8)
+            singleBuffer.collect(row.integer, at: 10)
+            singleBuffer.collect(row.short, at: 12)
+            singleBuffer.collect(row.flag, at: 14)
+            let singleBytes = try singleBuffer.finish()
+
+            XCTAssertEqual(Data(bytes: rowBytes.data, count: rowBytes.size),
+                           Data(bytes: singleBytes.data, count: singleBytes.size))
+        }
+    }
+
+    func testCollectRowSkipsAbsentFields() throws {
+        let row = ScalarRow(id: 1, aDouble: 2, aFloat: 3, integer: 4, short: 5, flag: true)
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        flatBuffer.collect(row: row, layout: FlatBufferTests.scalarRowLayout, presence: [0b110111])
+        let bytes = try flatBuffer.finish()
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        XCTAssertEqual(reader.read(at: 4) as UInt64?, 1)
+        XCTAssertEqual(reader.read(at: 6) as Double?, 2)
+        XCTAssertEqual(reader.read(at: 8) as Float?, 3)
+        XCTAssertNil(reader.read(at: 10) as Int32?)
+        XCTAssertEqual(reader.read(at: 12) as Int16?, 5)
+        XCTAssertEqual(reader.read(at: 14) as Bool?, true)
+    }
+
+    func testReadScalarsOfPropertiesMissingInOlderData() throws {
+        // E.g. data written before properties were added to the schema: the vtable only covers the first property
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        flatBuffer.collect(UInt64(7), at: 4)
+        let bytes = try flatBuffer.finish()
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        XCTAssertEqual(reader.read(at: 4) as UInt64, 7)
+        XCTAssertNil(reader.read(at: 6) as Double?)
+        XCTAssertNil(reader.read(at: 8) as Int32?)
+        XCTAssertNil(reader.read(at: 5) as UInt8?)  // Partly overlapping the vtable's end
+        XCTAssertEqual(reader.read(at: 10) as Int64, 0)
+        XCTAssertEqual(reader.read(at: 12) as Bool, false)
+        XCTAssertEqual(reader.read(at: UInt16.max - 1) as Float, 0)
+    }
+
+    func testReadRowRoundTrip() throws {
+        let row = ScalarRow(id: 42, aDouble: 3.5, aFloat: -1.25, integer: -7, short: 300, flag: true)
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        flatBuffer.collect(row: row, layout: FlatBufferTests.scalarRowLayout, presence: [0b110111])
+        let bytes = try flatBuffer.finish()
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        var readRow = ScalarRow(id: 0, aDouble: 0, aFloat: 0, integer: 99, short: 0, flag: false)
+        var presence = [UInt8]()
+        reader.read(row: &readRow, layout: FlatBufferTests.scalarRowLayout, presence: &presence)
+
+        XCTAssertEqual(presence, [0b110111])
+        XCTAssertEqual(readRow.id, 42)
+        XCTAssertEqual(readRow.aDouble, 3.5)
+        XCTAssertEqual(readRow.aFloat, -1.25)
+        XCTAssertEqual(readRow.integer, 0)  // Absent
+        XCTAssertEqual(readRow.short, 300)
+        XCTAssertEqual(readRow.flag, true)
+    }
+
+    func testReadRowOfPropertiesMissingInOlderData() throws {
+        // E.g. data written before properties were added to the schema: the vtable is shorter than the layout
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        flatBuffer.collect(UInt64(7), at: 4)
+        let bytes = try flatBuffer.finish()
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        var readRow = ScalarRow(id: 0, aDouble: 1, aFloat: 1, integer: 1, short: 1, flag: true)
+        var presence = [UInt8]()
+        reader.read(row: &readRow, layout: FlatBufferTests.scalarRowLayout, presence: &presence)
+
+        XCTAssertEqual(presence, [0b000001])
+        XCTAssertEqual(readRow.id, 7)
+        XCTAssertEqual(readRow.aDouble, 0)
+        XCTAssertEqual(readRow.flag, false)
+    }
+
+    func testStringsUseStoredLength() throws {
+        let strings = ["", "ASCII", "Ümläute und 🎉 emoji", "embedded\u{0}zero",
+                       String(repeating: "long ", count: 5_000), NSString(string: "bridged NSString ✓") as String]
+        for string in strings {
+            let flatBuffer = FlatBufferBuilder()
+            flatBuffer.isCollecting = true
+            let offset = flatBuffer.prepare(string: string)
+            XCTAssertGreaterThan(offset, 0)
+            flatBuffer.collect(dataOffset: offset, at: 4)
+            let bytes = try flatBuffer.finish()
+
+            var reader = FlatBufferReader()
+            reader.setCurrentlyReadTableBytes(bytes.data)
+            XCTAssertEqual(reader.read(at: 4) as String, string)
+            XCTAssertEqual(reader.read(at: 4) as String?, string)
+            XCTAssertNil(reader.read(at: 6) as String?)
+            XCTAssertEqual(reader.read(at: 6) as String, "")
+        }
+    }
+
+    func testStringVectorReadByIndex() throws {
+        let values = ["tag", "", "Ümläute 🎉", "last"]
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        let offset = flatBuffer.prepare(values: values)
+        let emptyOffset = flatBuffer.prepare(values: [String]())
+        flatBuffer.collect(dataOffset: offset, at: 4)
+        flatBuffer.collect(dataOffset: emptyOffset, at: 6)
+        let bytes = try flatBuffer.finish()
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        XCTAssertEqual(reader.read(at: 4) as [String]?, values)
+        XCTAssertEqual(reader.read(at: 6) as [String]?, [])
+        XCTAssertNil(reader.read(at: 8) as [String]?)
+        XCTAssertEqual(reader.read(at: 8) as [String], [])
+
+        let fbr = reader.unwrapFBR()
+        var cString: UnsafePointer<CChar>?
+        var length = 0
+        XCTAssertTrue(obx_fbr_read_strings_at(fbr, 4, 2, &cString, &length))
+        XCTAssertEqual(length, "Ümläute 🎉".utf8.count)
+        XCTAssertFalse(obx_fbr_read_strings_at(fbr, 4, 4, &cString, &length))
+        XCTAssertFalse(obx_fbr_read_strings_at(fbr, 8, 0, &cString, &length))
+    }
+
+    func testStringSpans() throws {
+        let longASCII = String(repeating: "0123456789", count: 10)
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        let asciiOffset = flatBuffer.prepare(values: ["", "tag", longASCII])
+        let utf8Offset = flatBuffer.prepare(values: [longASCII, longASCII + "Ümläute 🎉"])
+        flatBuffer.collect(dataOffset: asciiOffset, at: 4)
+        flatBuffer.collect(dataOffset: utf8Offset, at: 6)
+        let bytes = try flatBuffer.finish()
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        let fbr = reader.unwrapFBR()
+        var spans = [OBX_string_span](repeating: OBX_string_span(), count: 3)
+        var base: UnsafePointer<CChar>?
+        XCTAssertTrue(obx_fbr_read_string_spans(fbr, 4, &spans, spans.count, &base))
+        XCTAssertEqual(spans.map { $0.length }, [0, 3, UInt32(longASCII.utf8.count)])
+        XCTAssertEqual(String(cString: base! + Int(spans[1].offset)), "tag")
+
+        XCTAssertTrue(obx_fbr_read_string_spans(fbr, 6, &spans, spans.count, &base))
+        XCTAssertEqual(spans[1].length, UInt32((longASCII + "Ümläute 🎉").utf8.count))
+        XCTAssertEqual(String(cString: base! + Int(spans[1].offset)), longASCII + "Ümläute 🎉")
+
+        XCTAssertFalse(obx_fbr_read_string_spans(fbr, 4, &spans, 2, &base))  // Capacity too small
+        XCTAssertFalse(obx_fbr_read_string_spans(fbr, 8, &spans, spans.count, &base))
+    }
+
+    func testLargeStringVector() throws {
+        let values = (0 ..< 100_000).map { "value \($0)" } + ["embedded\u{0}zero", ""]
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        let offset = flatBuffer.prepare(values: values)
+        flatBuffer.collect(dataOffset: offset, at: 4)
+        let bytes = try flatBuffer.finish()
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        XCTAssertEqual(reader.read(at: 4) as [String], values)
+    }
+
+    func testVectorTypesRoundTrip() throws {
+        let shorts: [Int16] = [Int16.min, -1, 0, 1, Int16.max]
+        let chars: [UInt16] = Array("Ümläute".utf16)
+        let doubles: [Double] = [-Double.greatestFiniteMagnitude, -1.5, 0, .pi, Double.infinity]
+        let bools = [true, false, false, true]
+        let dates = [Date(timeIntervalSince1970: 0), Date(timeIntervalSince1970: 1_700_000_000.123)]
+        let nanoDates = [Date(timeIntervalSince1970: 1_700_000_000.123456)]
+
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        let offsets = [flatBuffer.prepare(values: shorts), flatBuffer.prepare(values: chars),
+                       flatBuffer.prepare(values: doubles), flatBuffer.prepare(values: bools),
+                       flatBuffer.prepare(values: dates), flatBuffer.prepareNanos(values: nanoDates),
+                       flatBuffer.prepare(values: [Double]())]
+        for (index, offset) in offsets.enumerated() {
+            flatBuffer.collect(dataOffset: offset, at: UInt16(4 + 2 * index))
+        }
+        let bytes = try flatBuffer.finish()
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        XCTAssertEqual(reader.read(at: 4) as [Int16], shorts)
+        XCTAssertEqual(reader.read(at: 6) as [UInt16], chars)
+        XCTAssertEqual(reader.read(at: 8) as [Double], doubles)
+        XCTAssertEqual(reader.read(at: 10) as [Bool], bools)
+        XCTAssertEqual((reader.read(at: 12) as [Date]).map { $0.unixTimestamp }, dates.map { $0.unixTimestamp })
+        let readNanoDates: [Date] = reader.readNanos(at: 14)
+        XCTAssertEqual(readNanoDates.count, 1)
+        XCTAssertEqual(readNanoDates[0].timeIntervalSince1970, nanoDates[0].timeIntervalSince1970, accuracy: 1e-6)
+        XCTAssertEqual(reader.read(at: 16) as [Double]?, [])
+
+        XCTAssertNil(reader.read(at: 18) as [Int16]?)
+        XCTAssertNil(reader.read(at: 18) as [UInt16]?)
+        XCTAssertNil(reader.read(at: 18) as [Double]?)
+        XCTAssertNil(reader.read(at: 18) as [Bool]?)
+        XCTAssertNil(reader.read(at: 18) as [Date]?)
+        XCTAssertNil(reader.readNanos(at: 18) as [Date]?)
+        XCTAssertEqual(reader.read(at: 18) as [Double], [])
+    }
+
+    func testVectorViewsPointIntoData() throws {
+        let ints: [Int32] = [Int32.min, 0, Int32.max]
+        let longs: [Int64] = [Int64.min, 0, Int64.max]
+        let floats: [Float] = [-1.5, 0, .pi]
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        let offsets = [flatBuffer.prepare(values: ints), flatBuffer.prepare(values: longs),
+                       flatBuffer.prepare(values: floats)]
+        for (index, offset) in offsets.enumerated() {
+            flatBuffer.collect(dataOffset: offset, at: UInt16(4 + 2 * index))
+        }
+        let bytes = try flatBuffer.finish()
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        let intsView: VectorView<Int32> = try XCTUnwrap(reader.read(at: 4))
+        let longsView: VectorView<Int64> = try XCTUnwrap(reader.read(at: 6))
+        let floatsView: VectorView<Float> = try XCTUnwrap(reader.read(at: 8))
+        XCTAssertEqual(Array(intsView), ints)
+        XCTAssertEqual(Array(longsView), longs)
+        XCTAssertEqual(Array(floatsView), floats)
+        XCTAssertNil(reader.read(at: 10) as VectorView<Float>?)
+
+        let dataRange = UnsafeRawPointer(bytes.data!) ..< UnsafeRawPointer(bytes.data!) + bytes.size
+        XCTAssertTrue(dataRange.contains(UnsafeRawPointer(floatsView.buffer.baseAddress!)))
+    }
+
+    /// Compares the inlinable Swift scalar reads with the C++ reference implementation over random tables.
+    // swiftlint:disable:next cyclomatic_complexity
+    func testScalarReadsMatchNativeReader() throws {
+        var random = SplitMix64(seed: 20)
+        for _ in 0 ..< 500 {
+            // Random type per field; 0 leaves it absent, fields after the last collected one are beyond the vtable
+            let types = (0 ..< random.next() % 16).map { _ in random.next() % 9 }
+            let flatBuffer = FlatBufferBuilder()
+            flatBuffer.isCollecting = true
+            for (field, type) in types.enumerated() {
+                let bits = random.next()
+                let offset = UInt16(4 + 2 * field)
+                switch type {
+                case 1: flatBuffer.collect(bits & 1 == 1, at: offset)
+                case 2: flatBuffer.collect(Int8(truncatingIfNeeded: bits), at: offset)
+                case 3: flatBuffer.collect(Int16(truncatingIfNeeded: bits), at: offset)
+                case 4: flatBuffer.collect(Int32(truncatingIfNeeded: bits), at: offset)
+                case 5: flatBuffer.collect(Int64(bitPattern: bits), at: offset)
+                case 6: flatBuffer.collect(UInt16(truncatingIfNeeded: bits), at: offset)
+                case 7: flatBuffer.collect(Float(bitPattern: UInt32(truncatingIfNeeded: bits)), at: offset)
+                case 8: flatBuffer.collect(Double(bitPattern: bits), at: offset)
+                default: break
+                }
+            }
+            flatBuffer.ensureStarted()
+            let bytes = try flatBuffer.finish()
+
+            var reader = FlatBufferReader()
+            reader.setCurrentlyReadTableBytes(bytes.data)
+            let fbr = reader.unwrapFBR()
+            for field in 0 ..< 20 {
+                let offset = UInt16(4 + 2 * field)
+                switch field < types.count ? types[field] : 0 {
+                case 1: XCTAssertEqual(reader.read(at: offset) as Bool?, nativeRead(fbr, offset, obx_fbr_read_bool))
+                case 2: XCTAssertEqual(reader.read(at: offset) as Int8?, nativeRead(fbr, offset, obx_fbr_read_int8))
+                case 3: XCTAssertEqual(reader.read(at: offset) as Int16?, nativeRead(fbr, offset, obx_fbr_read_int16))
+                case 4: XCTAssertEqual(reader.read(at: offset) as Int32?, nativeRead(fbr, offset, obx_fbr_read_int32))
+                case 5: XCTAssertEqual(reader.read(at: offset) as Int64?, nativeRead(fbr, offset, obx_fbr_read_int64))
+                case 6: XCTAssertEqual(reader.read(at: offset) as UInt16?,
+                                       nativeRead(fbr, offset, obx_fbr_read_uint16))
+                case 7: XCTAssertEqual((reader.read(at: offset) as Float?)?.bitPattern,
+                                       nativeRead(fbr, offset, obx_fbr_read_float)?.bitPattern)
+                case 8: XCTAssertEqual((reader.read(at: offset) as Double?)?.bitPattern,
+                                       nativeRead(fbr, offset, obx_fbr_read_double)?.bitPattern)
+                default:
+                    XCTAssertNil(nativeRead(fbr, offset, obx_fbr_read_int64))
+                    XCTAssertNil(reader.read(at: offset) as Int64?)
+                    XCTAssertEqual(reader.read(at: offset) as Int64, 0)
+                    XCTAssertFalse(reader.read(at: offset) as Bool)
+                }
+            }
+        }
+    }
+
+    private func nativeRead<T: Numeric>(_ fbr: OpaquePointer, _ offset: UInt16,
+                                        _ read: (OpaquePointer, UInt16, UnsafeMutablePointer<T>?) -> Bool) -> T? {
+        var result: T = 0
+        return read(fbr, offset, &result) ? result : nil
+    }
+
+    private func nativeRead(_ fbr: OpaquePointer, _ offset: UInt16,
+                            _ read: (OpaquePointer, UInt16, UnsafeMutablePointer<Bool>?) -> Bool) -> Bool? {
+        var result = false
+        return read(fbr, offset, &result) ? result : nil
+    }
+
+    func testFlexValueRoundTrip() throws {
+        let value = FlexValue.map([
+            "name": .string("Ümläute 🎉"),
+            "count": .int(-100_000),
+            "big": .uint(UInt64.max),
+            "ratio": .double(0.1),
+            "enabled": .bool(true),
+            "nothing": .null,
+            "raw": .blob(Data([0, 1, 2, 255])),
+            "list": .vector([.int(1), .double(4.5), .string(""), .vector([]), .map(["nested": .bool(false)])])
+        ])
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        let offsets = [flatBuffer.prepare(flex: value), flatBuffer.prepare(flex: .vector([])),
+                       flatBuffer.prepare(flex: .int(13)), flatBuffer.prepare(flex: nil)]
+        XCTAssertEqual(offsets[3], 0)
+        for (index, offset) in offsets.enumerated() {
+            flatBuffer.collect(dataOffset: offset, at: UInt16(4 + 2 * index))
+        }
+        let bytes = try flatBuffer.finish()
+        let stats = flatBuffer.stats
+        XCTAssertGreaterThan(stats.flex_capacity, 0)
+        XCTAssertGreaterThanOrEqual(stats.in_use_bytes, stats.capacity + stats.flex_capacity)
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        XCTAssertEqual(reader.read(at: 4) as FlexValue?, value)
+        XCTAssertEqual(reader.read(at: 6) as FlexValue?, .vector([]))
+        XCTAssertEqual(reader.read(at: 8) as FlexValue?, .int(13))
+        XCTAssertEqual(reader.read(at: 8) as [UInt8], [13, 4, 1])  // Plain FlexBuffers encoding
+        XCTAssertNil(reader.read(at: 10) as FlexValue?)
+        XCTAssertEqual(reader.read(at: 10) as FlexValue, .null)
+    }
+
+    /// Values with their encoding by the FlexBuffers reference implementation (flexbuffers.py of FlatBuffers 25.12.19,
+    /// keys not shared, map keys added in UTF-8 order).
+    static let flexReferenceEncodings: [(FlexValue, [UInt8])] = [
+        (.int(13),
+         [13, 4, 1]),
+        (.int(-70000),
+         [144, 238, 254, 255, 6, 4]),
+        (.uint(UInt64.max),
+         [255, 255, 255, 255, 255, 255, 255, 255, 11, 8]),
+        (.double(0.5),
+         [0, 0, 0, 63, 14, 4]),
+        (.double(0.1),
+         [154, 153, 153, 153, 153, 153, 185, 63, 15, 8]),
+        (.bool(true),
+         [1, 104, 1]),
+        (.null,
+         [0, 0, 1]),
+        (.string("Ümläute 🎉"),
+         [14, 195, 156, 109, 108, 195, 164, 117, 116, 101, 32, 240, 159, 142, 137, 0, 15, 20, 1]),
+        (.blob(Data([0, 1, 2, 255])),
+         [4, 0, 1, 2, 255, 4, 100, 1]),
+        (.vector([.int(1), .double(4.5), .string(""), .vector([]), .map(["nested": .bool(false)])]),
+         [0, 0, 0, 110, 101, 115, 116, 101, 100, 0, 1, 8, 1, 1, 1, 0, 104, 0, 0, 0, 5, 0, 0, 0, 1, 0, 0, 0, 0, 0, 144,
+          64, 31, 0, 0, 0, 33, 0, 0, 0, 25, 0, 0, 0, 6, 14, 20, 40, 36, 25, 42, 1]),
+        (.map(["name": .string("Ümläute 🎉"), "count": .int(-100_000), "ratio": .double(0.1), "nothing": .null,
+               "list": .vector([.int(300), .int(-1 << 40), .string("xyz")]), "Äpfel": .uint(1), "Zebra": .bool(true)]),
+         [90, 101, 98, 114, 97, 0, 99, 111, 117, 110, 116, 0, 108, 105, 115, 116, 0, 3, 120, 121, 122, 0, 0, 0, 3, 0, 0,
+          0, 0, 0, 0, 0, 44, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 255, 255, 255, 30, 0, 0, 0, 0, 0, 0, 0, 7, 7, 20, 110,
+          97, 109, 101, 0, 14, 195, 156, 109, 108, 195, 164, 117, 116, 101, 32, 240, 159, 142, 137, 0, 110, 111, 116,
+          104, 105, 110, 103, 0, 114, 97, 116, 105, 111, 0, 195, 132, 112, 102, 101, 108, 0, 7, 102, 97, 92, 46, 26, 19,
+          14, 0, 0, 0, 10, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 7, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+          96, 121, 254, 255, 255, 255, 255, 255, 120, 0, 0, 0, 0, 0, 0, 0, 95, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+          0, 154, 153, 153, 153, 153, 153, 185, 63, 1, 0, 0, 0, 0, 0, 0, 0, 107, 7, 43, 20, 3, 15, 11, 63, 39, 1])
+    ]
+
+    func testFlexEncodingMatchesReferenceImplementation() throws {
+        for (value, expected) in FlatBufferTests.flexReferenceEncodings {
+            let flatBuffer = FlatBufferBuilder()
+            flatBuffer.isCollecting = true
+            flatBuffer.collect(dataOffset: flatBuffer.prepare(flex: value), at: 4)
+            let bytes = try flatBuffer.finish()
+
+            var reader = FlatBufferReader()
+            reader.setCurrentlyReadTableBytes(bytes.data)
+            XCTAssertEqual(reader.read(at: 4) as [UInt8], expected, "\(value)")
+        }
+    }
+
+    func testFlexDecodesReferenceImplementationBuffers() throws {
+        // The reference builder with default settings: typed, fixed-size and bool vectors, indirect scalars and
+        // shared keys; and with shared strings
+        let defaultSettings: (FlexValue, [UInt8]) = (
+            .map(["typed": .vector([.int(1), .int(-2), .int(300)]), "floats": .vector([.double(1.5), .double(-0.25)]),
+                  "bools": .vector([.bool(true), .bool(false), .bool(true)]),
+                  "fixed": .vector([.int(7), .int(8), .int(9)]), "indirectInt": .int(-5), "indirectFloat": .double(2.5),
+                  "indirectUInt": .uint(1 << 63),
+                  "shared": .vector(Array(repeating: .map(["k": .string("same")]), count: 3))]),
+            [116, 121, 112, 101, 100, 0, 3, 0, 1, 0, 254, 255, 44, 1, 102, 108, 111, 97, 116, 115, 0, 0, 0, 0, 2, 0,
+             0, 0, 0, 0, 192, 63, 0, 0, 128, 190, 98, 111, 111, 108, 115, 0, 3, 1, 0, 1, 102, 105, 120, 101, 100, 0,
+             7, 8, 9, 105, 110, 100, 105, 114, 101, 99, 116, 73, 110, 116, 0, 251, 105, 110, 100, 105, 114, 101, 99,
+             116, 70, 108, 111, 97, 116, 0, 0, 0, 0, 0, 32, 64, 105, 110, 100, 105, 114, 101, 99, 116, 85, 73, 110,
+             116, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 128, 115, 104, 97, 114, 101, 100, 0, 107, 0, 4, 115, 97, 109, 101,
+             0, 1, 9, 1, 1, 1, 10, 20, 107, 0, 4, 115, 97, 109, 101, 0, 1, 9, 1, 1, 1, 10, 20, 107, 0, 4, 115, 97,
+             109, 101, 0, 1, 9, 1, 1, 1, 10, 20, 3, 33, 19, 5, 36, 36, 36, 8, 136, 127, 160, 107, 121, 89, 66, 179, 8,
+             1, 8, 140, 132, 157, 102, 120, 84, 24, 182, 144, 76, 54, 34, 24, 31, 40, 45, 16, 36, 1])
+        let sharedStrings: (FlexValue, [UInt8]) = (
+            .vector([.string("same"), .string("same"), .string("same"), .int(1)]),
+            [4, 115, 97, 109, 101, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 15, 0, 0, 0, 0, 0, 0, 0, 23, 0, 0, 0, 0, 0, 0, 0,
+             31, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 20, 20, 20, 7, 36, 43, 1])
+        for (expected, encoded) in FlatBufferTests.flexReferenceEncodings + [defaultSettings, sharedStrings] {
+            let flatBuffer = FlatBufferBuilder()
+            flatBuffer.isCollecting = true
+            flatBuffer.collect(dataOffset: flatBuffer.prepare(bytes: encoded), at: 4)
+            let bytes = try flatBuffer.finish()
+
+            var reader = FlatBufferReader()
+            reader.setCurrentlyReadTableBytes(bytes.data)
+            XCTAssertEqual(reader.read(at: 4) as FlexValue?, expected)
+        }
+    }
+
+    func testFlexReferenceLooksUpLazily() throws {
+        var entries: [String: FlexValue] = [:]
+        for i in 0 ..< 1_000 {
+            entries["key \(i)"] = .int(Int64(i))
+        }
+        entries["vector"] = .vector([.string("a"), .string("b")])
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        flatBuffer.collect(dataOffset: flatBuffer.prepare(flex: .map(entries)), at: 4)
+        let bytes = try flatBuffer.finish()
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        let root = try XCTUnwrap(reader.readFlex(at: 4))
+        XCTAssertTrue(root.isMap)
+        XCTAssertEqual(root.count, 1_001)
+        XCTAssertEqual(root.keys, entries.keys.sorted { $0.utf8.lexicographicallyPrecedes($1.utf8) })
+        XCTAssertEqual(root["key 742"]?.intValue, 742)
+        XCTAssertEqual(root["key 742"]?.doubleValue, 742)
+        XCTAssertNil(root["key 74"])
+        XCTAssertNil(root["key 7420"])
+        XCTAssertNil(root[-1])
+        let vector = try XCTUnwrap(root["vector"])
+        XCTAssertTrue(vector.isVector)
+        XCTAssertEqual(vector[1]?.stringValue, "b")
+        XCTAssertNil(vector[2])
+        XCTAssertNil(vector["a"])
+        XCTAssertNil(reader.readFlex(at: 6))
+    }
+
+    func testCompressedPropertiesRoundTrip() throws {
+        let text = (0 ..< 5_000).map { "Line \($0 % 50): Ümläute and more text. " }.joined()
+        let data = Data((0 ..< 100_000).map { UInt8(truncatingIfNeeded: $0 / 7) })
+        var generator = SystemRandomNumberGenerator()
+        let noise = (0 ..< 10_000).map { _ in UInt8.random(in: 0 ... 255, using: &generator) }
+        let small = "Too small to compress"
+        let statsBefore = FlatBufferBuilder.compressionStats
+
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        let offsets = [flatBuffer.prepare(string: text, compressed: true),
+                       flatBuffer.prepare(bytes: data, compressed: true),
+                       flatBuffer.prepare(bytes: noise, compressed: true),
+                       flatBuffer.prepare(string: small, compressed: true),
+                       flatBuffer.prepare(string: nil, compressed: true)]
+        XCTAssertEqual(offsets[4], 0)
+        for (index, offset) in offsets.enumerated() {
+            flatBuffer.collect(dataOffset: offset, at: UInt16(4 + 2 * index))
+        }
+        let bytes = try flatBuffer.finish()
+        XCTAssertLessThan(bytes.size, (text.utf8.count + data.count) / 4 + noise.count + 1_000)
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        XCTAssertEqual(try reader.read(at: 4, compressed: true) as String, text)
+        XCTAssertEqual(try reader.read(at: 6, compressed: true) as Data, data)
+        XCTAssertEqual(try reader.read(at: 8, compressed: true) as [UInt8], noise)
+        XCTAssertEqual(try reader.read(at: 10, compressed: true) as String, small)
+        XCTAssertNil(try reader.read(at: 12, compressed: true) as String?)
+        // Not marked as compressed: the stored bytes
+        XCTAssertLessThan((reader.read(at: 6) as Data).count, data.count)
+
+        let stats = FlatBufferBuilder.compressionStats
+        XCTAssertEqual(stats.compressed_count - statsBefore.compressed_count, 2)
+        XCTAssertEqual(stats.skipped_count - statsBefore.skipped_count, 1)  // Noise does not compress; small is ignored
+        XCTAssertGreaterThanOrEqual(stats.decompressed_count - statsBefore.decompressed_count, 2)
+        XCTAssertGreaterThan(stats.uncompressed_bytes - statsBefore.uncompressed_bytes,
+                             stats.compressed_bytes - statsBefore.compressed_bytes)
+    }
+
+    func testCompressionHeaderIsOnlyUsedForCompressedProperties() throws {
+        // Magic of a compressed payload with an uncompressed size of 0xFFFFFFFF, followed by a checksum and a block
+        var crafted: [UInt8] = [0xFF, 0x4F, 0x5A, 1, 0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0]
+        crafted.append(contentsOf: [0xF0, 0xFF, 0xFF] + [UInt8](repeating: 7, count: 100))
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        let dataOffset = flatBuffer.prepare(bytes: Data(crafted))
+        flatBuffer.collect(dataOffset: dataOffset, at: 4)
+        let bytes = try flatBuffer.finish()
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        XCTAssertEqual(reader.read(at: 4) as Data, Data(crafted))
+        XCTAssertEqual(reader.read(at: 4) as [UInt8], crafted)
+        // The size is rejected before allocating; the compressed bytes are not passed off as the value
+        XCTAssertThrowsError(try reader.read(at: 4, compressed: true) as Data) { error in
+            guard case ObjectBoxError.fileCorrupt = error else { return XCTFail("Unexpected error: \(error)") }
+        }
+    }
+
+    func testCorruptCompressedValueThrows() throws {
+        let text = (0 ..< 1_000).map { "Line \($0 % 10) " }.joined()
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        flatBuffer.collect(dataOffset: flatBuffer.prepare(string: text, compressed: true), at: 4)
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(try flatBuffer.finish().data)
+        var stored: [UInt8] = reader.read(at: 4)
+        XCTAssertLessThan(stored.count, text.utf8.count)
+        stored[8] ^= 0x55  // Checksum of the uncompressed value
+
+        let corruptBuffer = FlatBufferBuilder()
+        corruptBuffer.isCollecting = true
+        corruptBuffer.collect(dataOffset: corruptBuffer.prepare(bytes: stored), at: 4)
+        reader.setCurrentlyReadTableBytes(try corruptBuffer.finish().data)
+        XCTAssertThrowsError(try reader.read(at: 4, compressed: true) as String) { error in
+            guard case ObjectBoxError.fileCorrupt = error else { return XCTFail("Unexpected error: \(error)") }
+        }
+    }
+
+    func testUncompressedValueStartingLikeCompressedOneRoundTrips() throws {
+        // Stored as it is, this would be taken for a compressed value; so it is compressed although it is small
+        let lookalike: [UInt8] = [0xFF, 0x4F, 0x5A, 1, 0, 0, 0, 0, 0, 0, 0, 0, 42]
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        flatBuffer.collect(dataOffset: flatBuffer.prepare(bytes: lookalike, compressed: true), at: 4)
+        let bytes = try flatBuffer.finish()
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        XCTAssertEqual(try reader.read(at: 4, compressed: true) as [UInt8], lookalike)
+    }
+
+    func testQuantizedVectorsRoundTrip() throws {
+        let values: [Float] = [0, 1, -1, 0.5, 3.14159, -65504, 1e-6, 127]
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        let offsets = [flatBuffer.prepare(values: values, encoding: .float32),
+                       flatBuffer.prepare(values: values, encoding: .float16),
+                       flatBuffer.prepare(values: values, encoding: .int8),
+                       flatBuffer.prepare(values: [], encoding: .int8),
+                       flatBuffer.prepare(values: nil, encoding: .float16)]
+        XCTAssertEqual(offsets[4], 0)
+        for (index, offset) in offsets.enumerated() {
+            flatBuffer.collect(dataOffset: offset, at: UInt16(4 + 2 * index))
+        }
+        let bytes = try flatBuffer.finish()
+
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        XCTAssertEqual(reader.read(at: 4, encoding: .float32) as [Float], values)
+        XCTAssertEqual(reader.read(at: 4) as [Float], values)
+        let halves: [Float] = reader.read(at: 6, encoding: .float16)
+        XCTAssertEqual(halves, [0, 1, -1, 0.5, 3.140625, -65504, 17 * 0x1p-24, 127])  // 1e-6 is subnormal
+        XCTAssertEqual(reader.read(at: 6) as [UInt16], [0, 0x3C00, 0xBC00, 0x3800, 0x4248, 0xFBFF, 0x0011, 0x57F0])
+        let int8s: [Float] = reader.read(at: 8, encoding: .int8)
+        XCTAssertEqual(int8s.count, values.count)
+        for (value, quantized) in zip(values, int8s) {
+            XCTAssertEqual(quantized, value, accuracy: 65504 / 127 / 2)
+        }
+        XCTAssertEqual(reader.read(at: 10, encoding: .int8) as [Float]?, [])
+        XCTAssertNil(reader.read(at: 12, encoding: .float16) as [Float]?)
+        XCTAssertEqual(reader.read(at: 12, encoding: .int8) as [Float], [])
+    }
+
+    func testAlignedVectors() throws {
+        let floats = (0 ..< 33).map { Float($0) / 3 }
+        let longs = (0 ..< 5).map { Int64($0) << 40 }
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        let offsets = [flatBuffer.prepare(string: "odd"), flatBuffer.prepare(values: floats, alignment: 64),
+                       flatBuffer.prepare(string: "length"), flatBuffer.prepare(values: longs, alignment: 32)]
+        for (index, offset) in offsets.enumerated() {
+            flatBuffer.collect(dataOffset: offset, at: UInt16(4 + 2 * index))
+        }
+        let bytes = try flatBuffer.finish()
+        XCTAssertEqual(bytes.size % 64, 0)
+
+        // Aligned bytes (like the builder would pass them): no copy needed; misaligned bytes: an aligned copy
+        let memory = UnsafeMutableRawPointer.allocate(byteCount: bytes.size + 64, alignment: 64)
+        defer { memory.deallocate() }
+        let isInPlace = { (pointer: UnsafeRawPointer) -> Bool in
+            pointer >= UnsafeRawPointer(memory) && pointer < UnsafeRawPointer(memory) + bytes.size + 64
+        }
+        for shift in [0, 4] {
+            memory.advanced(by: shift).copyMemory(from: bytes.data!, byteCount: bytes.size)
+            var reader = FlatBufferReader()
+            reader.setCurrentlyReadTableBytes(memory.advanced(by: shift))
+            let readFloats = reader.withFloats(at: 6, alignment: 64) { buffer -> [Float] in
+                XCTAssertEqual(Int(bitPattern: buffer.baseAddress) % 64, 0)
+                XCTAssertEqual(isInPlace(buffer.baseAddress!), shift == 0)
+                return Array(buffer)
+            }
+            XCTAssertEqual(readFloats, floats)
+            let readLongs = reader.withLongs(at: 10, alignment: 32) { buffer -> [Int64] in
+                XCTAssertEqual(Int(bitPattern: buffer.baseAddress) % 32, 0)
+                XCTAssertEqual(isInPlace(buffer.baseAddress!), shift == 0)
+                return Array(buffer)
+            }
+            XCTAssertEqual(readLongs, longs)
+            XCTAssertNil(reader.withFloats(at: 12, alignment: 64) { $0.count })
+        }
+
+        // Invalid alignments are rejected natively (Swift callers fail their precondition before)
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        var result = OBX_float_array()
+        XCTAssertFalse(obx_fbr_read_floats_aligned(reader.unwrapFBR(), 6, 0, &result))
+        XCTAssertFalse(obx_fbr_read_floats_aligned(reader.unwrapFBR(), 6, 48, &result))
+        XCTAssertTrue(FlatBufferBuilder.isValid(alignment: 1))
+        XCTAssertTrue(FlatBufferBuilder.isValid(alignment: 256))
+        XCTAssertFalse(FlatBufferBuilder.isValid(alignment: 0))
+        XCTAssertFalse(FlatBufferBuilder.isValid(alignment: 48))
+        XCTAssertFalse(FlatBufferBuilder.isValid(alignment: 512))
+    }
+
+    func testPutLearnsSizeHint() throws {
+        let box = store.box(for: TestPerson.self)
+        let name = String(repeating: "Large name ", count: 3_000)
+        // Enough objects for the moving average to forget small persons put by other tests
+        try box.put((0 ..< 40).map { TestPerson(name: name, age: $0) })
+        try box.put(TestPerson(name: name, age: 40))
+        let hint = try XCTUnwrap(box.putSizeHint)
+        XCTAssertGreaterThanOrEqual(hint.objectCount, 41)
+        XCTAssertGreaterThan(hint.averageSize, name.utf8.count * 9 / 10)
+        XCTAssertGreaterThan(hint.reservedSize, hint.averageSize)
+
+        // A new builder reserves the learned size up front and thus does not grow while collecting
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        flatBuffer.start(entitySchemaId: TestPerson.entityInfo.entitySchemaId)
+        flatBuffer.collect(dataOffset: flatBuffer.prepare(string: name), at: 6)
+        _ = try flatBuffer.finish()
+        XCTAssertEqual(flatBuffer.stats.grow_events, 0)
+    }
+
+    // MARK: Benchmarks
+
+    /// Narrow entity (3 properties): serialization overhead per object dominates.
+    func testPerformancePutNarrowEntity() throws {
+        let box = store.box(for: TestPerson.self)
+        let persons = (0 ..< 10_000).map { TestPerson(name: "Person \($0)", age: $0) }
+
+        measure {
+            // swiftlint:disable:next force_try
+            try! box.put(persons, mode: .put)
+        }
+    }
+
+    func testPerformanceReadRow() throws {
+        let row = ScalarRow(id: 42, aDouble: 3.5, aFloat: -1.25, integer: -7, short: 300, flag: true)
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        flatBuffer.collect(row: row, layout: FlatBufferTests.scalarRowLayout)
+        let bytes = try flatBuffer.finish()
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        let layout = FlatBufferTests.scalarRowLayout
+
+        measure {
+            var readRow = ScalarRow(id: 0, aDouble: 0, aFloat: 0, integer: 0, short: 0, flag: false)
+            var sum: UInt64 = 0
+            for _ in 0 ..< 100_000 {
+                reader.read(row: &readRow, layout: layout)
+                sum &+= readRow.id
+            }
+            XCTAssertEqual(sum, 4_200_000)
+        }
+    }
+
+    /// Wide entity (all property types): per-property overhead dominates.
+    func testPerformanceHydrateScalarsInlined() throws {
+        let flatBuffer = FlatBufferBuilder()
+        let offsets = FlatBufferTests.collectLongs(into: flatBuffer)
+        let bytes = try flatBuffer.finish()
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+
+        measure {
+            var sum: Int64 = 0
+            for _ in 0 ..< 100_000 {
+                for offset in offsets {
+                    sum &+= reader.read(at: offset) as Int64
+                }
+            }
+            XCTAssertNotEqual(sum, 0)
+        }
+    }
+
+    /// Baseline for testPerformanceHydrateScalarsInlined(): the same reads as C calls (obx_fbr_read_*).
+    func testPerformanceHydrateScalarsNative() throws {
+        let flatBuffer = FlatBufferBuilder()
+        let offsets = FlatBufferTests.collectLongs(into: flatBuffer)
+        let bytes = try flatBuffer.finish()
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        let fbr = reader.unwrapFBR()
+
+        measure {
+            var sum: Int64 = 0
+            for _ in 0 ..< 100_000 {
+                for offset in offsets {
+                    var value: Int64 = 0
+                    _ = obx_fbr_read_int64(fbr, offset, &value)
+                    sum &+= value
+                }
+            }
+            XCTAssertNotEqual(sum, 0)
+        }
+    }
+
+    /// Collects 16 long properties, i.e. an object hydrated using 16 reads; returns their offsets.
+    private static func collectLongs(into flatBuffer: FlatBufferBuilder) -> [UInt16] {
+        let offsets = (0 ..< 16).map { UInt16(4 + 2 * $0) }
+        flatBuffer.isCollecting = true
+        for offset in offsets {
+            flatBuffer.collect(Int64(offset), at: offset)
+        }
+        return offsets
+    }
+
+    func testPerformancePutWideEntity() throws {
+        let box = store.box(for: AllTypesEntity.self)
+        let entities: [AllTypesEntity] = (0 ..< 10_000).map {
+            let entity = AllTypesEntity.create(integer: Int32($0), double: Double($0), string: "Entity \($0)")
+            entity.boolean = $0 % 2 == 0
+            entity.aLong = $0
+            entity.unsigned = UInt32($0)
+            entity.date = Date(timeIntervalSince1970: TimeInterval($0))
+            return entity
+        }
+
+        measure {
+            // swiftlint:disable:next force_try
+            try! box.put(entities, mode: .put)
+        }
+    }
+
+    /// Recall@10 of exact nearest neighbor search on quantized vectors vs. the float32 baseline, and their sizes.
+    /// Takes a while and is thus only run if the environment variable OBX_BENCHMARK is set to "true".
+    func testQuantizedVectorRecall() throws {
+        guard ProcessInfo.processInfo.environment["OBX_BENCHMARK"] == "true" else { return }
+        let dimensions = 256
+        let vectorCount = 2_000
+        let queryCount = 20
+        var random = SplitMix64(seed: 42)
+        let vectors = (0 ..< vectorCount).map { _ in (0 ..< dimensions).map { _ in random.nextFloat() } }
+        let queries = (0 ..< queryCount).map { _ in (0 ..< dimensions).map { _ in random.nextFloat() } }
+
+        for distanceType in [HnswDistanceType.euclidean, .cosine] {
+            let baseline = queries.map { nearest(10, to: $0, in: vectors, distanceType: distanceType) }
+            for encoding in [VectorEncoding.float16, .int8] {
+                let decoded = try vectors.map { try roundTrip($0, encoding: encoding) }
+                var hits = 0
+                for (query, expected) in zip(queries, baseline) {
+                    hits += nearest(10, to: query, in: decoded, distanceType: distanceType).intersection(expected).count
+                }
+                let recall = Double(hits) / Double(10 * queryCount)
+                print("\(distanceType) \(encoding): recall@10 \(recall), \(encoding.byteCount(dimensions: dimensions)) "
+                      + "bytes per vector (float32: \(VectorEncoding.float32.byteCount(dimensions: dimensions)))")
+                XCTAssertGreaterThanOrEqual(recall, encoding == .float16 ? 0.98 : 0.9)
+            }
+        }
+    }
+
+    private func roundTrip(_ vector: [Float], encoding: VectorEncoding) throws -> [Float] {
+        let flatBuffer = FlatBufferBuilder()
+        flatBuffer.isCollecting = true
+        flatBuffer.collect(dataOffset: flatBuffer.prepare(values: vector, encoding: encoding), at: 4)
+        let bytes = try flatBuffer.finish()
+        var reader = FlatBufferReader()
+        reader.setCurrentlyReadTableBytes(bytes.data)
+        return reader.read(at: 4, encoding: encoding)
+    }
+
+    private func nearest(_ count: Int, to query: [Float], in vectors: [[Float]],
+                         distanceType: HnswDistanceType) -> Set<Int> {
+        let distances = vectors.map { vector -> Float in
+            var dot: Float = 0, squaredDistance: Float = 0, norm: Float = 0, queryNorm: Float = 0
+            for (value, queryValue) in zip(vector, query) {
+                dot += value * queryValue
+                squaredDistance += (value - queryValue) * (value - queryValue)
+                norm += value * value
+                queryNorm += queryValue * queryValue
+            }
+            return distanceType == .cosine ? 1 - dot / (norm * queryNorm).squareRoot() : squaredDistance
+        }
+        return Set(distances.indices.sorted { distances[$0] < distances[$1] }.prefix(count))
+    }
+}
+
+/// Deterministic random numbers for benchmarks.
+private struct SplitMix64 {
+    var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E3779B97F4A7C15
+        var value = state
+        value = (value ^ (value >> 30)) &* 0xBF58476D1CE4E5B9
+        value = (value ^ (value >> 27)) &* 0x94D049BB133111EB
+        return value ^ (value >> 31)
+    }
+
+    /// A float in -1 ..< 1.
+    mutating func nextFloat() -> Float {
+        return Float(next() >> 40) / Float(1 << 23) - 1
+    }
+}
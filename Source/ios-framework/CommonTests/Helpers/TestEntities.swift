@@ -58,6 +58,17 @@ extension TestPerson: Hashable {
     }
 }
 
+/// Has a to-one relation to its own entity type, e.g. to put an object together with a new object it refers to.
+public class TestReferral {
+    var id: EntityId<TestReferral> = 0
+    var name: String
+    var referrer: ToOne<TestReferral> = nil
+
+    init(name: String = "") {
+        self.name = name
+    }
+}
+
 public class AllTypesEntity {
     public var id: EntityId<AllTypesEntity> = 0
     public var boolean: Bool = false
@@ -154,6 +165,14 @@ public func createTestModel(syncEnabled: Bool = false) -> OpaquePointer {
     try! structEntityBuilder.addProperty(name: "date", type: .date, id: 3, uid: 14)
     try! structEntityBuilder.lastProperty(id: 3, uid: 14)
 
+    let referralEntityBuilder = try! modelBuilder.entityBuilder(for: TestReferral.self, id: 8, uid: 1003)
+    try! referralEntityBuilder.addProperty(name: "id", type: .long, flags: .id, id: 1, uid: 15)
+    try! referralEntityBuilder.addProperty(name: "name", type: .string, id: 2, uid: 16)
+    try! referralEntityBuilder.addToOneRelation(name: "referrer", targetEntityInfo: TestReferral.entityInfo,
+                                                flags: [.indexed, .indexPartialSkipZero], id: 3, uid: 17,
+                                                indexId: 4, indexUid: 18)
+    try! referralEntityBuilder.lastProperty(id: 3, uid: 17)
+
     // Copied from actual generated entity info; which is clumsy...
     // Probably should clean up and just use generated entity info directly for all entity types.
     let entityBuilder = try! modelBuilder.entityBuilder(for: UniqueEntity.self, id: 7, uid: 6258744021471265280)
@@ -222,8 +241,8 @@ public func createTestModel(syncEnabled: Bool = false) -> OpaquePointer {
     try! entityBuilder.addProperty(name: "str59", type: PropertyType.string, id: 63, uid: 4473980843763389184)
     try! entityBuilder.lastProperty(id: 63, uid: 4473980843763389184)
 
-    modelBuilder.lastEntity(id: 7, uid: 6258744021471265280)
-    modelBuilder.lastIndex(id: 3, uid: 4943227758701996288)
+    modelBuilder.lastEntity(id: 8, uid: 1003)
+    modelBuilder.lastIndex(id: 4, uid: 18)
 
     return modelBuilder.finish()
 }
@@ -249,6 +268,16 @@ extension TestPerson: Entity, EntityInspectable, __EntityRelatable {
     }
 }
 
+extension TestReferral: Entity, EntityInspectable, __EntityRelatable {
+    public typealias EntityBindingType = TestReferralCursor
+
+    public static var entityBinding = EntityBindingType()
+
+    public static var entityInfo = EntityInfo(name: "TestReferral", id: 8)
+
+    public var _id: EntityId<TestReferral> { return self.id }
+}
+
 extension AllTypesEntity: Entity, EntityInspectable, __EntityRelatable {
     public typealias EntityType = AllTypesEntity
 
@@ -322,6 +351,53 @@ public class TestPersonCursor: EntityBinding {
     }
 }
 
+public class TestReferralCursor: EntityBinding {
+    public typealias EntityType = TestReferral
+    public typealias IdType = EntityId<TestReferral>
+
+    public required init() {}
+
+    public func generatorBindingVersion() -> Int { 1 }
+
+    public func setEntityIdUnlessStruct(of entity: TestReferral, to entityId: Id) {
+        entity.id = EntityId(entityId)
+    }
+
+    public func entityId(of entity: TestReferral) -> Id {
+        return entity.id.value
+    }
+
+    public func collect(fromEntity entity: TestReferral, id: Id, propertyCollector: FlatBufferBuilder,
+                        store: Store) throws {
+        let nameOffset = propertyCollector.prepare(string: entity.name)
+        propertyCollector.collect(id, at: 4)
+        propertyCollector.collect(dataOffset: nameOffset, at: 6)
+        try propertyCollector.collect(entity.referrer, at: 8, store: store)
+    }
+
+    public func postPut(fromEntity entity: TestReferral, id: Id, store: Store) {
+        if entityId(of: entity) == 0 {  // New object was put? Attach relations now that we have an ID.
+            entity.referrer.attach(to: store.box(for: TestReferral.self))
+        }
+    }
+
+    public func setToOneRelation(_ propertyId: obx_schema_id, of entity: TestReferral, to entityId: Id?) {
+        switch propertyId {
+        case 3:
+            entity.referrer.targetId = entityId.map { EntityId<TestReferral>($0) }
+        default:
+            fatalError("Attempt to change nonexistent ToOne relation with ID \(propertyId)")
+        }
+    }
+
+    public func createEntity(entityReader: FlatBufferReader, store: Store) -> TestReferral {
+        let result = TestReferral()
+        result.id = EntityId(entityReader.read(at: 4))
+        result.name = entityReader.read(at: 6)
+        result.referrer = entityReader.read(at: 8, store: store)
+        return result
+    }
+}
 
 public class AllTypesEntityCursor: EntityBinding {
     public typealias EntityType = AllTypesEntity
@@ -253,4 +253,32 @@ class HnswIndexTest: XCTestCase {
         XCTAssertEqual(juice[0].object.name, "Apple juice")
     }
     // swiftlint:enable function_body_length
+    
+    func testVisitReadersWithVectorViews() throws {
+        let box: Box<HnswObject> = store.box()
+        try box.put((1...10).map { HnswObject(name: "node" + String($0), floatVector: [Float($0), Float($0) * 2]) })
+        let floatVectorOffset: UInt16 = 2 + 2 * 3
+        
+        // Dot products computed directly on the stored data
+        var dotProducts = [Float]()
+        try box.visitReaders { reader in
+            let vector: VectorView<Float> = try XCTUnwrap(reader.read(at: floatVectorOffset))
+            dotProducts.append(zip(vector, [1, 1]).reduce(0) { $0 + $1.0 * $1.1 })
+            return dotProducts.count < 5
+        }
+        XCTAssertEqual(dotProducts, [3, 6, 9, 12, 15])
+        
+        let query = try box
+            .query { HnswObject.floatVector.nearestNeighbors(queryVector: [5, 10], maxCount: 3) }
+            .build()
+        var copies = [[Float]]()
+        try query.visitReaders { reader in
+            let vector: VectorView<Float> = try XCTUnwrap(reader.read(at: floatVectorOffset))
+            copies.append(Array(vector))  // Copy to keep the values beyond the visitor
+            return true
+        }
+        XCTAssertEqual(copies, [[4, 8], [5, 10], [6, 12]])
+        
+        XCTAssertThrowsError(try query.visitReaders { _ in throw ObjectBoxError.illegalState(message: "test") })
+    }
 }
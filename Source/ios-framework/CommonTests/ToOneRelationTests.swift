@@ -121,6 +121,25 @@ class ToOneRelationTests: OneToManyTestCase {
 
     // MARK: Backlinks
 
+    func testParallelEncodedPutPutsNewTargets() throws {
+        orderBox.encodesPutsInParallel = true
+        let orders: [Order] = (0 ..< 2_000).map { index in
+            let order = Order()
+            if index % 100 == 0 {
+                order.customer.target = Customer(name: "New customer \(index)")
+            }
+            return order
+        }
+        try orderBox.put(orders)
+
+        XCTAssertEqual(try customerBox.count(), 20)
+        // Falling back to putting on the calling thread reuses the IDs reserved for the parallel put
+        XCTAssertEqual(orders.last?.id, Id(orders.count))
+        let storedOrders = try orderBox.get(orders.map { $0.id })
+        XCTAssertEqual(storedOrders.count, orders.count)
+        XCTAssertEqual(try orderBox.get(orders[100].id)?.customer.target?.name, "New customer 100")
+    }
+
     func testBacklinkAlone_WithoutBacklinks() throws {
         let customer = Customer(name: "A customer")
         let customerId = try customerBox.put(customer)
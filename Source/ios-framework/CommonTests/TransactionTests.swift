@@ -60,6 +60,27 @@ class TransactionTests: XCTestCase {
         FlatBufferBuilder.return(flatBuffer2)
         XCTAssert(flatBuffer1 === flatBuffer2)
     }
+
+    func testFlatBufferPoolReusesNestedObjects() {
+        let outer1 = FlatBufferBuilder.dequeue()
+        let nested1 = FlatBufferBuilder.dequeue()
+        XCTAssert(outer1 !== nested1)
+        FlatBufferBuilder.return(nested1)
+        FlatBufferBuilder.return(outer1)
+
+        let outer2 = FlatBufferBuilder.dequeue()
+        let nested2 = FlatBufferBuilder.dequeue()
+        FlatBufferBuilder.return(nested2)
+        FlatBufferBuilder.return(outer2)
+        XCTAssert(outer1 === outer2)
+        XCTAssert(nested1 === nested2)
+
+        // Builders not taken from the pool are not added to it
+        FlatBufferBuilder.return(FlatBufferBuilder())
+        let outer3 = FlatBufferBuilder.dequeue()
+        FlatBufferBuilder.return(outer3)
+        XCTAssert(outer3 === outer1)
+    }
     
     @available(iOS 10.0, macOS 10.12, *)
     func testFlatBuffersAreSeparateOnThreads() {
@@ -43,4 +43,15 @@ class UtilTests: XCTestCase {
         let int32Array: [Int32] = [Int32.min, -1000, 0, 1000, Int32.max]
         XCTAssertEqual(Util.toInt64Array(int32Array), [Int64(Int32.min), -1000, 0, 1000, Int64(Int32.max)])
     }
+
+    func testWithArrayOfCStrings() {
+        let strings = ["a", "", "Ümläute 🎉"] + (0 ..< 100_000).map { "string \($0)" }
+        let roundTrip: [String] = Util.withArrayOfCStrings(strings) { cStrings, count in
+            (0 ..< count).map { String(cString: cStrings[$0]!) }
+        }
+        XCTAssertEqual(roundTrip, strings)
+
+        let emptyCount = Util.withArrayOfCStrings([]) { _, count in count }
+        XCTAssertEqual(emptyCount, 0)
+    }
 }